@@ -0,0 +1,117 @@
+#include "Affinity.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+int coreCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+#ifdef _WIN32
+
+bool pinCurrentThread(int core) {
+    if (core < 0 || core >= coreCount() || core >= 64) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+}
+
+int numaNodeOfCore(int core) {
+    UCHAR node = 0;
+    if (core < 0 || core > 255 || !GetNumaProcessorNode(static_cast<UCHAR>(core), &node) || node == 0xFF) {
+        return 0;
+    }
+    return node;
+}
+
+void* allocateNumaMemory(size_t size, int node) {
+    void* memory = node >= 0 ?
+        VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>(node)) :
+        VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (memory != nullptr) {
+        // Touch the pages now instead of on the first frame
+        std::memset(memory, 0, size);
+    }
+    return memory;
+}
+
+void freeNumaMemory(void* memory, size_t) {
+    if (memory != nullptr) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+    }
+}
+
+#else
+
+bool pinCurrentThread(int core) {
+    if (core < 0 || core >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+int numaNodeOfCore(int core) {
+    // /sys/devices/system/cpu/cpuN/ contains a "nodeM" link on NUMA kernels
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(core);
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    int node = 0;
+    while (dirent* entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+void* allocateNumaMemory(size_t size, int node) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+#ifdef SYS_mbind
+    if (node >= 0 && node < 64) {
+        // MPOL_PREFERRED: take pages from 'node' while it has free memory (no libnuma needed)
+        const int mpolPreferred = 1;
+        unsigned long nodeMask = 1ul << node;
+        if (syscall(SYS_mbind, memory, size, mpolPreferred, &nodeMask, sizeof(nodeMask) * 8, 0) != 0) {
+            std::cerr << "mbind to NUMA node " << node << " failed, using default placement." << std::endl;
+        }
+    }
+#endif
+    // Fault the pages in now, on the chosen node, instead of on the first frame
+    std::memset(memory, 0, size);
+    return memory;
+}
+
+void freeNumaMemory(void* memory, size_t size) {
+    if (memory != nullptr) {
+        munmap(memory, size);
+    }
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <cstddef>
+
+// Thread placement and NUMA-local memory, Windows and Linux. Cores are logical
+// processor numbers as shown by Task Manager / lscpu (on Windows the first
+// processor group, i.e. cores 0-63).
+
+// Pin the calling thread to one core. Returns false if the core does not exist.
+bool pinCurrentThread(int core);
+
+// Number of logical processors
+int coreCount();
+
+// NUMA node a core belongs to, 0 if unknown or not a NUMA machine
+int numaNodeOfCore(int core);
+
+// Allocate 'size' bytes placed on NUMA node 'node' (node < 0: no preference).
+// The memory is committed and zeroed. Release with freeNumaMemory().
+void* allocateNumaMemory(size_t size, int node);
+void freeNumaMemory(void* memory, size_t size);
+
+#endif // AFFINITY_H
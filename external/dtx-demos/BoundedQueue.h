@@ -0,0 +1,115 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// What push() does when the queue is full
+enum class BackpressurePolicy {
+    DropOldest, // Discard the oldest queued item to make room
+    DropNewest, // Reject the item being pushed
+    Block       // Wait until a consumer makes room
+};
+
+// Fixed-capacity multi-consumer FIFO with a configurable backpressure policy.
+// Storage is allocated once in the constructor.
+template <typename T>
+class BoundedQueue {
+public:
+    enum class PushResult {
+        Queued,        // Item queued
+        DroppedOldest, // Item queued, 'dropped' holds the evicted oldest item
+        DroppedNewest, // Item rejected, 'dropped' holds it
+        Closed         // Queue closed, 'dropped' holds the item
+    };
+
+private:
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::vector<T> items;
+    size_t head = 0;
+    size_t count = 0;
+    uint64_t popped = 0;
+    BackpressurePolicy policy;
+    bool closed = false;
+
+public:
+    BoundedQueue(size_t capacity, BackpressurePolicy policy)
+        : items(capacity > 0 ? capacity : 1), policy(policy) {
+    }
+
+    // Push an item according to the backpressure policy
+    PushResult push(T item, T& dropped) {
+        std::unique_lock<std::mutex> lock(mutex);
+        PushResult result = PushResult::Queued;
+
+        if (policy == BackpressurePolicy::Block) {
+            notFull.wait(lock, [this] { return closed || count < items.size(); });
+        }
+        if (closed) {
+            dropped = std::move(item);
+            return PushResult::Closed;
+        }
+        if (count == items.size()) {
+            if (policy == BackpressurePolicy::DropNewest) {
+                dropped = std::move(item);
+                return PushResult::DroppedNewest;
+            }
+            dropped = std::move(items[head]);
+            head = (head + 1) % items.size();
+            --count;
+            result = PushResult::DroppedOldest;
+        }
+
+        items[(head + count) % items.size()] = std::move(item);
+        ++count;
+        lock.unlock();
+        notEmpty.notify_one();
+        return result;
+    }
+
+    // Wait for an item. Returns false once the queue is closed and empty.
+    // 'ticket' receives the item's position in pop order (0, 1, 2, ...), dropped items not counted.
+    bool pop(T& out, uint64_t* ticket = nullptr) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || count > 0; });
+        if (count == 0) {
+            return false;
+        }
+        if (ticket != nullptr) {
+            *ticket = popped;
+        }
+        ++popped;
+        out = std::move(items[head]);
+        items[head] = T();
+        head = (head + 1) % items.size();
+        --count;
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    // Wake all waiters; queued items can still be popped
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+    size_t capacity() const { return items.size(); }
+};
+
+#endif // BOUNDEDQUEUE_H
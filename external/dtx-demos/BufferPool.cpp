@@ -0,0 +1,48 @@
+#include "BufferPool.h"
+#include "Affinity.h"
+#include <new>
+
+BufferPool::State::~State() {
+    for (uint8_t* buffer : storage) {
+        freeNumaMemory(buffer, bufferSize);
+    }
+}
+
+BufferPool::BufferPool(size_t count, size_t bufferSize, int numaNode)
+    : state(std::make_shared<State>()) {
+    state->bufferSize = bufferSize;
+    state->storage.reserve(count);
+    state->freeList.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        // Committed and touched here instead of on the first frame
+        uint8_t* buffer = static_cast<uint8_t*>(allocateNumaMemory(bufferSize, numaNode));
+        if (buffer == nullptr) {
+            throw std::bad_alloc();
+        }
+        state->storage.push_back(buffer);
+        state->freeList.push_back(buffer);
+    }
+}
+
+std::shared_ptr<uint8_t> BufferPool::acquire() {
+    uint8_t* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->freeList.empty()) {
+            return nullptr;
+        }
+        buffer = state->freeList.back();
+        state->freeList.pop_back();
+    }
+
+    std::shared_ptr<State> owner = state;
+    return std::shared_ptr<uint8_t>(buffer, [owner](uint8_t* released) {
+        std::lock_guard<std::mutex> lock(owner->mutex);
+        owner->freeList.push_back(released);
+    });
+}
+
+size_t BufferPool::available() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->freeList.size();
+}
@@ -0,0 +1,39 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Fixed set of equally sized buffers, allocated once. A buffer handed out by
+// acquire() goes back to the pool when its last reference is dropped, the
+// same way an ic4::ImageBuffer goes back to the sink's free queue.
+class BufferPool {
+private:
+    struct State {
+        std::mutex mutex;
+        std::vector<uint8_t*> storage;
+        std::vector<uint8_t*> freeList;
+        size_t bufferSize = 0;
+        ~State();
+    };
+
+    // Shared with every handed out buffer, so buffers may outlive the pool object
+    std::shared_ptr<State> state;
+
+public:
+    // numaNode >= 0 places the buffers on that NUMA node (see allocateNumaMemory)
+    BufferPool(size_t count, size_t bufferSize, int numaNode = -1);
+
+    // Take a free buffer. Returns nullptr if all buffers are in use.
+    std::shared_ptr<uint8_t> acquire();
+
+    size_t bufferSize() const { return state->bufferSize; }
+    size_t capacity() const { return state->storage.size(); }
+    // Buffers currently not in use
+    size_t available() const;
+};
+
+#endif // BUFFERPOOL_H
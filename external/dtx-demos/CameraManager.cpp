@@ -0,0 +1,355 @@
+#include "CameraManager.h"
+#include "Affinity.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+static std::string trim(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    const size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+static void parseNameList(const std::string& value, std::vector<std::string>& names) {
+    names.clear();
+    std::stringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) {
+            names.push_back(item);
+        }
+    }
+}
+
+static bool parseCoreList(const std::string& value, std::vector<int>& cores) {
+    cores.clear();
+    std::stringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        item = trim(item);
+        if (item.empty()) {
+            continue;
+        }
+        char* end = nullptr;
+        long core = std::strtol(item.c_str(), &end, 10);
+        if (*end != '\0' || core < 0) {
+            return false;
+        }
+        cores.push_back(static_cast<int>(core));
+    }
+    return true;
+}
+
+// Apply one "key = value" line to 'camera'. Returns false for unknown keys or bad values.
+static bool applyCameraKey(CameraConfig& camera, const std::string& key, const std::string& value) {
+    char* end = nullptr;
+    auto toLong = [&](long& out) {
+        out = std::strtol(value.c_str(), &end, 10);
+        return !value.empty() && *end == '\0';
+    };
+    long number = 0;
+
+    if (key == "name") camera.name = value;
+    else if (key == "serial") camera.serial = value;
+    else if (key == "source") camera.source = value;
+    else if (key == "pixel_format") {
+        camera.pixelFormat = value;
+        return value == "Mono8" || value == "RGB8" || value == "BGR8";
+    }
+    else if (key == "replay") camera.replayPath = value;
+    else if (key == "solution") camera.solutionPath = value;
+    else if (key == "fps") {
+        camera.fps = std::strtod(value.c_str(), &end);
+        return *end == '\0';
+    }
+    else if (key == "policy") {
+        if (value == "drop-oldest") camera.pipeline.policy = BackpressurePolicy::DropOldest;
+        else if (value == "drop-newest") camera.pipeline.policy = BackpressurePolicy::DropNewest;
+        else if (value == "block") camera.pipeline.policy = BackpressurePolicy::Block;
+        else return false;
+    }
+    else if (key == "inspection_cores") return parseCoreList(value, camera.pipeline.workerCores);
+    else if (key == "procedure") {
+        parseNameList(value, camera.procedures);
+        return !camera.procedures.empty();
+    }
+    else if (!toLong(number)) return false;
+    else if (key == "width") camera.width = static_cast<int>(number);
+    else if (key == "height") camera.height = static_cast<int>(number);
+    // Counts below 1 would wrap to huge sizes
+    else if ((key == "buffers" || key == "workers" || key == "queue") && number < 1) return false;
+    else if (key == "buffers") camera.bufferCount = static_cast<size_t>(number);
+    else if (key == "workers") camera.pipeline.workerCount = static_cast<size_t>(number);
+    else if (key == "queue") camera.pipeline.queueCapacity = static_cast<size_t>(number);
+    else if (key == "acquisition_core") camera.acquisitionCore = static_cast<int>(number);
+    else if (key == "numa_node") camera.numaNode = static_cast<int>(number);
+    else return false;
+    return true;
+}
+
+bool loadCameraConfigs(const std::string& path, std::vector<CameraConfig>& cameras) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open camera config " << path << std::endl;
+        return false;
+    }
+
+    cameras.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line == "[camera]") {
+            cameras.emplace_back();
+            continue;
+        }
+
+        const size_t equals = line.find('=');
+        if (cameras.empty() || equals == std::string::npos) {
+            std::cerr << path << ":" << lineNumber << ": expected [camera] or key = value" << std::endl;
+            return false;
+        }
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+        if (!applyCameraKey(cameras.back(), key, value)) {
+            std::cerr << path << ":" << lineNumber << ": invalid setting '" << key << "'" << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        CameraConfig& camera = cameras[i];
+        if (camera.source == "ic4" && camera.serial.empty()) {
+            std::cerr << path << ": camera " << i << " has no serial" << std::endl;
+            return false;
+        }
+        if (camera.name.empty()) {
+            camera.name = camera.serial.empty() ? "camera" + std::to_string(i) : camera.serial;
+        }
+    }
+    if (cameras.empty()) {
+        std::cerr << path << ": no [camera] sections" << std::endl;
+        return false;
+    }
+
+    // One solution per process: cameras without a solution key use the one the others name
+    std::string solution;
+    for (const CameraConfig& camera : cameras) {
+        if (camera.solutionPath.empty()) {
+            continue;
+        }
+        if (!solution.empty() && camera.solutionPath != solution) {
+            std::cerr << path << ": cameras name different solutions (" << solution << ", "
+                << camera.solutionPath << "), use one solution with a procedure per camera" << std::endl;
+            return false;
+        }
+        solution = camera.solutionPath;
+    }
+    for (CameraConfig& camera : cameras) {
+        camera.solutionPath = solution;
+    }
+    return true;
+}
+
+CameraManager::CameraManager(SourceFactory sourceFactory, EngineFactoryProvider engineFactoryProvider,
+    ResultCallback resultCallback)
+    : sourceFactory(std::move(sourceFactory)), engineFactoryProvider(std::move(engineFactoryProvider)),
+    resultCallback(std::move(resultCallback)) {
+}
+
+CameraManager::~CameraManager() {
+    stop();
+    if (metrics) {
+        metrics->removeCounters(metricsCounters);
+    }
+}
+
+bool CameraManager::open(const std::vector<CameraConfig>& configs) {
+    stop();
+    cameras.clear();
+
+    for (size_t index = 0; index < configs.size(); ++index) {
+        std::unique_ptr<Camera> camera(new Camera());
+        camera->config = configs[index];
+        if (camera->config.numaNode < 0 && camera->config.acquisitionCore >= 0) {
+            camera->config.numaNode = numaNodeOfCore(camera->config.acquisitionCore);
+        }
+        const CameraConfig& config = camera->config;
+
+        camera->source = sourceFactory ? sourceFactory(config) : nullptr;
+        if (!camera->source) {
+            std::cerr << "Failed to open camera " << config.name << "." << std::endl;
+            cameras.clear();
+            return false;
+        }
+
+        camera->engineFactory = engineFactoryProvider ? engineFactoryProvider(config) : nullptr;
+
+        std::cout << "Camera " << config.name << ": " << camera->source->description() << std::endl;
+        cameras.push_back(std::move(camera));
+        createPipeline(index);
+    }
+    return true;
+}
+
+void CameraManager::createPipeline(size_t index) {
+    Camera& camera = *cameras[index];
+    // Destroyed first, so its counters are unregistered before the new ones are added
+    camera.pipeline.reset();
+    camera.pipeline.reset(new InspectionPipeline(camera.config.pipeline, camera.engineFactory,
+        [this, index](const InspectedFrame& inspected) {
+            if (resultCallback) {
+                resultCallback(index, inspected);
+            }
+        }));
+    camera.pipelineStopped = false;
+    if (metrics) {
+        camera.pipeline->attachMetrics(*metrics, "camera=\"" + camera.config.name + "\"");
+    }
+}
+
+void CameraManager::attachMetrics(MetricsRegistry& registry) {
+    for (auto& camera : cameras) {
+        camera->pipeline->attachMetrics(registry, "camera=\"" + camera->config.name + "\"");
+    }
+
+    if (metrics) {
+        metrics->removeCounters(metricsCounters);
+    }
+    metrics = &registry;
+    metricsCounters = registry.addCounters([this](std::vector<MetricSample>& samples) {
+        for (const auto& camera : cameras) {
+            const std::string labels = "camera=\"" + camera->config.name + "\"";
+            const SourceStatistics stats = camera->source->statistics();
+            samples.push_back(MetricSample{ "dtx_source_delivered_total", labels, static_cast<double>(stats.delivered), false });
+            samples.push_back(MetricSample{ "dtx_device_underruns_total", labels, static_cast<double>(stats.deviceUnderruns), false });
+            samples.push_back(MetricSample{ "dtx_transmission_errors_total", labels, static_cast<double>(stats.transmissionErrors), false });
+            samples.push_back(MetricSample{ "dtx_sink_underruns_total", labels, static_cast<double>(stats.sinkUnderruns), false });
+            samples.push_back(MetricSample{ "dtx_buffers_in_flight", labels, static_cast<double>(camera->source->buffersInFlight()), true });
+        }
+    });
+}
+
+bool CameraManager::start() {
+    if (running) {
+        return true;
+    }
+
+    // Set first, so stop() also unwinds the cameras started before a failing one
+    running = true;
+    startTime = std::chrono::steady_clock::now();
+
+    for (size_t index = 0; index < cameras.size(); ++index) {
+        Camera* camera = cameras[index].get();
+        camera->acquisitionPinned = false;
+        if (camera->pipelineStopped) {
+            createPipeline(index);
+        }
+        if (!camera->pipeline->start()) {
+            stop();
+            return false;
+        }
+
+        // The source calls this on its own acquisition thread (the IC4 sink thread or the
+        // simulator's thread); pin that thread on its first frame
+        InspectionPipeline* pipeline = camera->pipeline.get();
+        const bool started = camera->source->startStream([camera, pipeline](FrameHandle frame) {
+            if (camera->config.acquisitionCore >= 0 && !camera->acquisitionPinned.exchange(true)) {
+                if (!pinCurrentThread(camera->config.acquisitionCore)) {
+                    std::cerr << "Cannot pin acquisition of " << camera->config.name
+                        << " to core " << camera->config.acquisitionCore << "." << std::endl;
+                }
+            }
+            pipeline->submit(std::move(frame));
+        });
+        if (!started) {
+            std::cerr << "Failed to start camera " << camera->config.name << "." << std::endl;
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void CameraManager::stop() {
+    if (!running) {
+        return;
+    }
+
+    // Stop every stream first, so no camera keeps producing while another one drains
+    for (auto& camera : cameras) {
+        camera->source->stopStream();
+    }
+    for (auto& camera : cameras) {
+        camera->pipeline->stop();
+        camera->pipelineStopped = true;
+    }
+    running = false;
+}
+
+std::vector<CameraStatistics> CameraManager::statistics() const {
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::vector<CameraStatistics> result;
+    result.reserve(cameras.size());
+    for (const auto& camera : cameras) {
+        CameraStatistics stats;
+        stats.name = camera->config.name;
+        stats.source = camera->source->statistics();
+        stats.submitted = camera->pipeline->submittedCount();
+        stats.dropped = camera->pipeline->droppedCount();
+        stats.failed = camera->pipeline->failedCount();
+        stats.published = camera->pipeline->publishedCount();
+        stats.peakBuffersInFlight = camera->source->peakBuffersInFlight();
+        stats.throughputFps = elapsed > 0.0 ? stats.published / elapsed : 0.0;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+std::string CameraManager::statisticsText() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+
+    CameraStatistics total;
+    total.name = "total";
+    for (const CameraStatistics& stats : statistics()) {
+        out << stats.name << ": " << stats.throughputFps << " frames/s"
+            << ", inspected " << stats.published
+            << ", dropped " << stats.dropped
+            << ", failed " << stats.failed
+            << ", sink underruns " << stats.source.sinkUnderruns
+            << ", device underruns " << stats.source.deviceUnderruns
+            << ", peak buffers " << stats.peakBuffersInFlight << "\n";
+        total.throughputFps += stats.throughputFps;
+        total.published += stats.published;
+        total.dropped += stats.dropped;
+        total.failed += stats.failed;
+        total.source.sinkUnderruns += stats.source.sinkUnderruns;
+        total.source.deviceUnderruns += stats.source.deviceUnderruns;
+    }
+    out << total.name << ": " << total.throughputFps << " frames/s"
+        << ", inspected " << total.published
+        << ", dropped " << total.dropped
+        << ", failed " << total.failed
+        << ", sink underruns " << total.source.sinkUnderruns
+        << ", device underruns " << total.source.deviceUnderruns << "\n";
+    return out.str();
+}
@@ -0,0 +1,115 @@
+#ifndef CAMERAMANAGER_H
+#define CAMERAMANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ICameraSource.h"
+#include "InspectionPipeline.h"
+#include "MetricsRegistry.h"
+
+// One camera of a cell, read from a config file (see loadCameraConfigs)
+struct CameraConfig {
+    std::string name;               // Label in logs and metrics, defaults to the serial
+    std::string serial;             // Device serial number (ic4), ignored by synthetic sources
+    std::string source = "ic4";     // "ic4" or "synthetic"
+    int width = 0;                  // 0 = source default
+    int height = 0;
+    std::string pixelFormat = "RGB8"; // Sink format: Mono8, RGB8 or BGR8
+    double fps = 30.0;              // Synthetic sources only
+    std::string replayPath;         // Synthetic sources only
+    size_t bufferCount = 8;
+    PipelineConfig pipeline;        // Workers, queue, policy and workerCores (inspection_cores)
+    int acquisitionCore = -1;       // Pin the thread delivering frames, -1 = no pinning
+    int numaNode = -1;              // Buffer pool node, -1 = node of acquisitionCore (if pinned)
+    std::string solutionPath;       // Inspection solution, the same for every camera; empty = engine default
+    std::vector<std::string> procedures; // Procedures in the solution for worker i % size, empty = engine default
+};
+
+// Parse a camera config file. Every "[camera]" section starts a camera, followed by
+// "key = value" lines; '#' starts a comment. Keys: name, serial, source, width, height,
+// pixel_format, fps, replay, buffers, workers, queue, policy (drop-oldest|drop-newest|block),
+// acquisition_core, inspection_cores (comma separated), numa_node, solution, procedure
+// (comma separated). VisionMaster holds one solution per process, so a file whose cameras
+// name different solutions is rejected; cameras are told apart by their procedures.
+bool loadCameraConfigs(const std::string& path, std::vector<CameraConfig>& cameras);
+
+// Throughput and drop counters of one camera
+struct CameraStatistics {
+    std::string name;
+    SourceStatistics source;
+    uint64_t submitted = 0;
+    uint64_t dropped = 0;       // Dropped by the inspection queue
+    uint64_t failed = 0;
+    uint64_t published = 0;
+    size_t peakBuffersInFlight = 0;
+    double throughputFps = 0.0; // Published results per second since start()
+};
+
+// Runs several cameras side by side. Every camera gets its own source (with its own
+// acquisition thread), its own inspection pipeline with its own engine objects and its
+// own buffers, so a slow camera only ever backs up into its own queue. Engines that share
+// backend state (a VisionMaster procedure) are serialized by the backend, so cameras stay
+// independent only if they do not share it.
+class CameraManager {
+public:
+    using SourceFactory = std::function<std::unique_ptr<ICameraSource>(const CameraConfig&)>;
+    // Engine factory for one camera's pipeline, called once per camera
+    using EngineFactoryProvider = std::function<InspectionPipeline::EngineFactory(const CameraConfig&)>;
+    // Called on the camera's publisher thread, in frame order per camera
+    using ResultCallback = std::function<void(size_t cameraIndex, const InspectedFrame&)>;
+
+private:
+    struct Camera {
+        CameraConfig config;
+        std::unique_ptr<ICameraSource> source;
+        InspectionPipeline::EngineFactory engineFactory;
+        std::unique_ptr<InspectionPipeline> pipeline;
+        bool pipelineStopped = false; // A stopped pipeline accepts no frames, start() builds a new one
+        std::atomic<bool> acquisitionPinned{ false };
+    };
+
+    SourceFactory sourceFactory;
+    EngineFactoryProvider engineFactoryProvider;
+    ResultCallback resultCallback;
+    std::vector<std::unique_ptr<Camera>> cameras;
+    std::chrono::steady_clock::time_point startTime;
+    bool running = false;
+    MetricsRegistry* metrics = nullptr;
+    int metricsCounters = 0;
+
+    // (Re)create the camera's pipeline, attached to the metrics if attachMetrics() was called
+    void createPipeline(size_t index);
+
+public:
+    CameraManager(SourceFactory sourceFactory, EngineFactoryProvider engineFactoryProvider,
+        ResultCallback resultCallback = nullptr);
+    ~CameraManager();
+
+    CameraManager(const CameraManager&) = delete;
+    CameraManager& operator=(const CameraManager&) = delete;
+
+    // Create (connect) every camera. Fails if any camera cannot be opened.
+    bool open(const std::vector<CameraConfig>& configs);
+    // Record every camera's stage latencies and counters, labelled camera="<name>". Call before start().
+    void attachMetrics(MetricsRegistry& registry);
+    // Start all pipelines and streams; after stop() the pipelines are rebuilt, counters restart at 0
+    bool start();
+    // Stop all streams, then let every pipeline finish its queued frames
+    void stop();
+
+    size_t cameraCount() const { return cameras.size(); }
+    const CameraConfig& config(size_t index) const { return cameras[index]->config; }
+    ICameraSource& source(size_t index) { return *cameras[index]->source; }
+
+    std::vector<CameraStatistics> statistics() const;
+    // One line per camera plus a total
+    std::string statisticsText() const;
+};
+
+#endif // CAMERAMANAGER_H
@@ -0,0 +1,24 @@
+#ifndef CAMERAPROFILE_H
+#define CAMERAPROFILE_H
+
+#include <cstdint>
+#include <string>
+
+// A set of camera parameters applied together (TISCameraIC4::applyProfile).
+// Every field has a "leave unchanged" value, so a profile only touches what it sets.
+struct CameraProfile {
+    double exposureUs = -1.0;   // < 0 = unchanged; switches ExposureAuto off
+    double gainDb = -1.0;       // < 0 = unchanged; switches GainAuto off
+
+    // Region of interest; ROI changes need a stopped stream
+    int64_t width = 0;          // 0 = unchanged
+    int64_t height = 0;
+    int64_t offsetX = -1;       // < 0 = unchanged
+    int64_t offsetY = -1;
+
+    std::string triggerSource;  // Empty = unchanged, e.g. "Software", "Line1"
+    double triggerDelayUs = -1.0; // < 0 = unchanged
+    int triggerMode = -1;       // -1 = unchanged, 0 = free run, 1 = triggered
+};
+
+#endif // CAMERAPROFILE_H
@@ -0,0 +1,102 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Host timestamp used for all stage timings (nanoseconds, steady clock)
+inline uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Pixel layouts passed between the camera, the inspection and the display
+enum class FramePixelFormat {
+    Unknown,
+    Mono8,
+    BGR8,
+    BGRa8,
+    RGB8
+};
+
+// Bytes per pixel for a frame pixel format (0 for Unknown)
+inline int bytesPerPixel(FramePixelFormat format) {
+    switch (format) {
+    case FramePixelFormat::Mono8: return 1;
+    case FramePixelFormat::BGR8:  return 3;
+    case FramePixelFormat::BGRa8: return 4;
+    case FramePixelFormat::RGB8:  return 3;
+    default:                      return 0;
+    }
+}
+
+// Non-owning description of an image in memory
+struct ImageView {
+    const uint8_t* data = nullptr;
+    int width = 0;
+    int height = 0;
+    size_t stride = 0; // Bytes per row, may include padding
+    FramePixelFormat format = FramePixelFormat::Unknown;
+};
+
+// A grabbed frame. The pixels are not copied: 'owner' keeps the backing
+// storage (e.g. the ic4::ImageBuffer popped from the sink) alive, so the
+// buffer only goes back to the sink's free queue once the frame is released.
+struct Frame {
+    uint64_t frameNumber = 0;
+    uint64_t deviceTimestampNs = 0; // Camera clock
+    uint64_t hostTimestampNs = 0;   // steadyNowNs() when the frame was popped from the sink
+    ImageView image;
+    std::shared_ptr<const void> owner;
+};
+
+// Ref-counted, read-only frame shared between consumers
+using FrameHandle = std::shared_ptr<const Frame>;
+
+// Hands out FrameHandles and counts how many of them are still referenced.
+// The peak value is what the sink's buffer count has to cover.
+class FrameTracker {
+private:
+    struct Counters {
+        std::atomic<size_t> inFlight{ 0 };
+        std::atomic<size_t> peakInFlight{ 0 };
+    };
+
+    // Frame that decrements the in-flight counter when the last handle is dropped
+    struct TrackedFrame : Frame {
+        std::shared_ptr<Counters> counters;
+
+        TrackedFrame(Frame&& frame, std::shared_ptr<Counters> c)
+            : Frame(std::move(frame)), counters(std::move(c)) {
+        }
+        ~TrackedFrame() {
+            counters->inFlight.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+    // Shared with every frame, so handles may outlive the tracker
+    std::shared_ptr<Counters> counters = std::make_shared<Counters>();
+
+public:
+    // Wrap a frame into a handle that is counted while alive
+    FrameHandle track(Frame&& frame) {
+        size_t now = counters->inFlight.fetch_add(1, std::memory_order_relaxed) + 1;
+        size_t peak = counters->peakInFlight.load(std::memory_order_relaxed);
+        while (now > peak &&
+            !counters->peakInFlight.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+        }
+        return std::make_shared<TrackedFrame>(std::move(frame), counters);
+    }
+
+    // Number of frames currently referenced by at least one consumer
+    size_t buffersInFlight() const { return counters->inFlight.load(std::memory_order_relaxed); }
+    // Highest number of frames referenced at the same time
+    size_t peakBuffersInFlight() const { return counters->peakInFlight.load(std::memory_order_relaxed); }
+    void resetPeak() { counters->peakInFlight.store(buffersInFlight(), std::memory_order_relaxed); }
+};
+
+#endif // FRAME_H
@@ -0,0 +1,302 @@
+#include "FrameHistory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef DTX_HAVE_OPENCV
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#endif
+
+namespace fs = std::filesystem;
+
+FrameHistory::FrameHistory(const FrameHistoryConfig& config)
+    : config(config), pending(std::max<size_t>(config.maxPendingArchives, 1)) {
+    this->config.capacity = std::max<size_t>(config.capacity, 1);
+    slots.resize(this->config.capacity);
+    if (config.maxFrameBytes > 0) {
+        allocateSlots(config.maxFrameBytes);
+    }
+}
+
+FrameHistory::~FrameHistory() {
+    stop();
+}
+
+void FrameHistory::allocateSlots(size_t bytes) {
+    for (Slot& slot : slots) {
+        slot.pixels.resize(bytes);
+    }
+    slotBytes = bytes;
+}
+
+bool FrameHistory::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return true;
+    }
+    std::error_code error;
+    fs::create_directories(config.directory, error);
+    if (error) {
+        std::cerr << "Cannot create history directory " << config.directory << ": " << error.message() << std::endl;
+        return false;
+    }
+    running = true;
+    writerThread = std::thread(&FrameHistory::writerLoop, this);
+    return true;
+}
+
+void FrameHistory::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        if (windowOpen) {
+            queueArchiveLocked(windowFirst, nextIndex, windowFrameNumber, "nok");
+            windowOpen = false;
+        }
+        running = false;
+    }
+    wake.notify_all();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+void FrameHistory::record(const InspectedFrame& inspected) {
+    if (!inspected.frame) {
+        return;
+    }
+    const Frame& frame = *inspected.frame;
+    const size_t rowBytes = static_cast<size_t>(frame.image.width) * bytesPerPixel(frame.image.format);
+    const size_t bytes = rowBytes * frame.image.height;
+
+    Slot* slot = nullptr;
+    uint64_t index = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (slotBytes == 0) {
+            // Sized by the first frame, the only allocation of the history
+            allocateSlots(bytes);
+        }
+        index = nextIndex;
+        slot = &slots[index % slots.size()];
+        if (bytes == 0 || bytes > slotBytes || slot->pins > 0) {
+            ++skipped;
+            return;
+        }
+        slot->filled = false;
+    }
+
+    // Copy outside the lock; archive() only pins filled slots and the writer only reads pinned ones
+    for (int y = 0; y < frame.image.height; ++y) {
+        std::memcpy(slot->pixels.data() + y * rowBytes, frame.image.data + y * frame.image.stride, rowBytes);
+    }
+    slot->width = frame.image.width;
+    slot->height = frame.image.height;
+    slot->format = frame.image.format;
+    slot->deviceTimestampNs = frame.deviceTimestampNs;
+    slot->hostTimestampNs = frame.hostTimestampNs;
+    slot->result = inspected.result;
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slot->index = index;
+        slot->filled = true;
+        nextIndex = index + 1;
+        ++recorded;
+
+        const bool nok = !inspected.result.valid || !inspected.result.ok;
+        if (config.archiveOnNok && nok) {
+            if (!windowOpen) {
+                windowOpen = true;
+                windowFirst = index >= config.framesBefore ? index - config.framesBefore : 0;
+                windowFrameNumber = inspected.result.frameNumber;
+            }
+            windowAfter = config.framesAfter;
+        }
+        else if (windowOpen && windowAfter > 0) {
+            --windowAfter;
+        }
+        // A window longer than the ring would overwrite its own first frames
+        if (windowOpen && (windowAfter == 0 || nextIndex - windowFirst >= slots.size())) {
+            queued = queueArchiveLocked(windowFirst, nextIndex, windowFrameNumber, "nok");
+            windowOpen = false;
+        }
+    }
+    if (queued) {
+        wake.notify_one();
+    }
+}
+
+bool FrameHistory::archive(const char* reason) {
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running || nextIndex == 0) {
+            return false;
+        }
+        const uint64_t first = nextIndex > config.framesBefore + 1 ? nextIndex - config.framesBefore - 1 : 0;
+        const Slot& last = slots[(nextIndex - 1) % slots.size()];
+        queued = queueArchiveLocked(first, nextIndex, last.result.frameNumber, reason);
+    }
+    if (queued) {
+        wake.notify_one();
+    }
+    return queued;
+}
+
+bool FrameHistory::queueArchiveLocked(uint64_t first, uint64_t end, uint64_t triggerFrameNumber, const char* reason) {
+    if (!running) {
+        return false;
+    }
+    if (pendingCount == pending.size()) {
+        ++archivesDropped;
+        return false;
+    }
+
+    // Only frames still in the ring
+    const uint64_t oldest = nextIndex > slots.size() ? nextIndex - slots.size() : 0;
+    first = std::max(first, oldest);
+    while (first < end) {
+        const Slot& slot = slots[first % slots.size()];
+        if (slot.filled && slot.index == first) {
+            break;
+        }
+        ++first;
+    }
+    if (first >= end) {
+        return false;
+    }
+
+    for (uint64_t i = first; i < end; ++i) {
+        ++slots[i % slots.size()].pins;
+    }
+    Archive& archive = pending[(pendingHead + pendingCount) % pending.size()];
+    archive.first = first;
+    archive.count = static_cast<size_t>(end - first);
+    archive.triggerFrameNumber = triggerFrameNumber;
+    archive.reason = reason;
+    ++pendingCount;
+    return true;
+}
+
+void FrameHistory::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return !running || pendingCount > 0; });
+        if (pendingCount == 0) {
+            return; // Stopped and everything is written
+        }
+
+        const Archive archive = pending[pendingHead];
+        lock.unlock();
+        writeArchive(archive);
+        lock.lock();
+
+        for (uint64_t i = archive.first; i < archive.first + archive.count; ++i) {
+            --slots[i % slots.size()].pins;
+        }
+        pendingHead = (pendingHead + 1) % pending.size();
+        --pendingCount;
+        ++archivesWritten;
+    }
+}
+
+void FrameHistory::writeArchive(const Archive& archive) {
+    const uint64_t wallTimeMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    std::ostringstream name;
+    name << archive.reason << "_" << archive.triggerFrameNumber << "_" << wallTimeMs;
+    const fs::path directory = fs::path(config.directory) / name.str();
+
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Cannot create " << directory.string() << ": " << error.message() << std::endl;
+        return;
+    }
+
+    std::ofstream csv((directory / "results.csv").string(), std::ios::trunc);
+    csv << "sequence,frame_number,device_timestamp_ns,host_timestamp_ns,valid,ok,value,outputs,image\n";
+
+    std::vector<uint8_t> scratch;
+    for (uint64_t i = archive.first; i < archive.first + archive.count; ++i) {
+        const Slot& slot = slots[i % slots.size()];
+        const InspectionResult& result = slot.result;
+
+        std::ostringstream imageName;
+        imageName << "frame_" << result.sequence;
+        const std::string basePath = (directory / imageName.str()).string();
+        const std::string imagePath = writeFrame(slot, basePath, scratch);
+        if (imagePath.empty()) {
+            std::cerr << "Cannot write " << basePath << std::endl;
+        }
+
+        // Parameters separated by ';', their values by ' '
+        csv << result.sequence << "," << result.frameNumber << "," << slot.deviceTimestampNs << ","
+            << slot.hostTimestampNs << "," << result.valid << "," << result.ok << "," << result.value << ",";
+        size_t value = 0;
+        for (uint32_t p = 0; p < result.outputs.paramCount; ++p) {
+            csv << (p > 0 ? ";" : "");
+            for (uint32_t v = 0; v < result.outputs.paramSizes[p]; ++v, ++value) {
+                csv << (v > 0 ? " " : "") << result.outputs.values[value];
+            }
+        }
+        csv << "," << fs::path(imagePath).filename().string() << "\n";
+    }
+
+    std::cout << "Archived " << archive.count << " frames to " << directory.string() << std::endl;
+}
+
+std::string FrameHistory::writeFrame(const Slot& slot, const std::string& basePath, std::vector<uint8_t>& scratch) {
+    const int bpp = bytesPerPixel(slot.format);
+
+#ifdef DTX_HAVE_OPENCV
+    (void)scratch;
+    const std::string path = basePath + ".png";
+    const int type = bpp == 1 ? CV_8UC1 : bpp == 4 ? CV_8UC4 : CV_8UC3;
+    cv::Mat image(slot.height, slot.width, type, const_cast<uint8_t*>(slot.pixels.data()));
+    cv::Mat bgr;
+    if (slot.format == FramePixelFormat::RGB8) {
+        cv::cvtColor(image, bgr, cv::COLOR_RGB2BGR);
+        image = bgr;
+    }
+    try {
+        return cv::imwrite(path, image, { cv::IMWRITE_PNG_COMPRESSION, config.pngCompression }) ? path : std::string();
+    }
+    catch (const cv::Exception&) {
+        return std::string();
+    }
+#else
+    // Binary PGM/PPM; PPM is RGB, so BGR(a) is reordered
+    const size_t pixels = static_cast<size_t>(slot.width) * slot.height;
+    const bool gray = slot.format == FramePixelFormat::Mono8;
+    const uint8_t* data = slot.pixels.data();
+    if (!gray) {
+        scratch.resize(pixels * 3);
+        const bool bgr = slot.format != FramePixelFormat::RGB8;
+        for (size_t i = 0; i < pixels; ++i) {
+            const uint8_t* in = data + i * bpp;
+            uint8_t* out = scratch.data() + i * 3;
+            out[0] = in[bgr ? 2 : 0];
+            out[1] = in[1];
+            out[2] = in[bgr ? 0 : 2];
+        }
+        data = scratch.data();
+    }
+
+    const std::string path = basePath + (gray ? ".pgm" : ".ppm");
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << (gray ? "P5" : "P6") << "\n" << slot.width << " " << slot.height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(data), pixels * (gray ? 1 : 3));
+    return file ? path : std::string();
+#endif
+}
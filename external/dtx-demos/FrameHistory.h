@@ -0,0 +1,115 @@
+#ifndef FRAMEHISTORY_H
+#define FRAMEHISTORY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InspectionResult.h"
+
+struct FrameHistoryConfig {
+    size_t capacity = 32;        // Frames kept in memory
+    size_t framesBefore = 8;     // Frames before a NOK (or archive() call) that are archived with it
+    size_t framesAfter = 4;      // Frames after a NOK; later NOKs within these extend the window
+    size_t maxFrameBytes = 0;    // Slot size, 0 = size of the first recorded frame
+    bool archiveOnNok = true;    // Archive the window around every NOK (invalid results count as NOK)
+    std::string directory = "history";
+    int pngCompression = 3;      // 0-9. Frames are PNG with OpenCV, uncompressed .pgm/.ppm without it.
+    size_t maxPendingArchives = 4; // Windows waiting for the writer; more are dropped
+};
+
+// In-memory history of the last frames with their complete results, so a NOK part can be
+// looked at afterwards. All slots are allocated once (on construction, or with the first
+// frame if maxFrameBytes is 0); record() copies the pixels into the next slot, so no
+// sink buffer is held and nothing is allocated per frame.
+//
+// On a NOK, or when archive() is called, the frames around it are handed to a writer
+// thread that stores them (images plus a results.csv) in their own directory below
+// 'directory'. Slots being written are skipped by record() until the writer is done, so
+// neither the publisher nor the inspection ever waits for the disk.
+class FrameHistory {
+private:
+    struct Slot {
+        std::vector<uint8_t> pixels;  // Tight rows
+        int width = 0;
+        int height = 0;
+        FramePixelFormat format = FramePixelFormat::Unknown;
+        uint64_t deviceTimestampNs = 0;
+        uint64_t hostTimestampNs = 0;
+        InspectionResult result;
+        uint64_t index = 0;  // Position in the recording, valid if 'filled'
+        bool filled = false;
+        int pins = 0;        // Archives still to be written that contain this slot
+    };
+
+    struct Archive {
+        uint64_t first = 0;  // Recording index of the first frame
+        size_t count = 0;
+        uint64_t triggerFrameNumber = 0;
+        const char* reason = "";
+    };
+
+    FrameHistoryConfig config;
+    std::vector<Slot> slots;
+    size_t slotBytes = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread writerThread;
+    bool running = false;
+    uint64_t nextIndex = 0;
+
+    // Window around a NOK that is still collecting its frames after the NOK
+    bool windowOpen = false;
+    uint64_t windowFirst = 0;
+    size_t windowAfter = 0;
+    uint64_t windowFrameNumber = 0;
+
+    // Archives waiting for the writer (preallocated ring)
+    std::vector<Archive> pending;
+    size_t pendingHead = 0;
+    size_t pendingCount = 0;
+
+    std::atomic<uint64_t> recorded{ 0 };
+    std::atomic<uint64_t> skipped{ 0 };
+    std::atomic<uint64_t> archivesWritten{ 0 };
+    std::atomic<uint64_t> archivesDropped{ 0 };
+
+    void allocateSlots(size_t bytes);
+    // Pin the recorded frames [first, end) and queue them for the writer. Caller holds the mutex.
+    bool queueArchiveLocked(uint64_t first, uint64_t end, uint64_t triggerFrameNumber, const char* reason);
+    void writeArchive(const Archive& archive);
+    // Write one frame as basePath + extension; returns the file written, empty on failure
+    std::string writeFrame(const Slot& slot, const std::string& basePath, std::vector<uint8_t>& scratch);
+    void writerLoop();
+
+public:
+    explicit FrameHistory(const FrameHistoryConfig& config = FrameHistoryConfig());
+    ~FrameHistory();
+
+    FrameHistory(const FrameHistory&) = delete;
+    FrameHistory& operator=(const FrameHistory&) = delete;
+
+    // Start the writer thread
+    bool start();
+    // Queue the open NOK window, write every queued archive and stop the writer
+    void stop();
+
+    // Keep a copy of the frame and its result. Call from one thread, the result callback.
+    void record(const InspectedFrame& inspected);
+    // Archive the last framesBefore + 1 recorded frames (any thread)
+    bool archive(const char* reason = "manual");
+
+    uint64_t recordedCount() const { return recorded.load(); }
+    // Frames not kept because their slot was still being written or the frame was too large
+    uint64_t skippedCount() const { return skipped.load(); }
+    uint64_t archivesWrittenCount() const { return archivesWritten.load(); }
+    // Archives lost because too many were waiting for the writer
+    uint64_t archivesDroppedCount() const { return archivesDropped.load(); }
+};
+
+#endif // FRAMEHISTORY_H
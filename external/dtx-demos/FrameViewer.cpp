@@ -0,0 +1,128 @@
+#include "FrameViewer.h"
+#include <algorithm>
+#include <opencv2/highgui.hpp>
+#include <opencv2/imgproc.hpp>
+
+// Wrap a frame's pixels into a cv::Mat header (no copy)
+static cv::Mat wrapFrame(const Frame& frame) {
+    int type = CV_8UC3;
+    switch (frame.image.format) {
+    case FramePixelFormat::Mono8: type = CV_8UC1; break;
+    case FramePixelFormat::BGRa8: type = CV_8UC4; break;
+    default: break;
+    }
+    return cv::Mat(frame.image.height, frame.image.width, type,
+        const_cast<uint8_t*>(frame.image.data), frame.image.stride);
+}
+
+FrameViewer::FrameViewer(const ViewerConfig& config)
+    : config(config) {
+}
+
+void FrameViewer::publish(const InspectedFrame& inspected) {
+    // Only hand over as many frames as will be shown; the rest go straight back to the sink
+    const uint64_t now = steadyNowNs();
+    if (!running || now < nextAcceptNs.load(std::memory_order_relaxed) || !inspected.frame) {
+        return;
+    }
+    const double fps = config.maxFps > 0.0 ? config.maxFps : 1000.0;
+    nextAcceptNs.store(now + static_cast<uint64_t>(1e9 / fps), std::memory_order_relaxed);
+    latest.publish(inspected);
+}
+
+void FrameViewer::render(const InspectedFrame& inspected) {
+    cv::Mat cameraImage = wrapFrame(*inspected.frame);
+
+    // Downsample first, so conversion and overlay only touch the displayed pixels
+    if (config.maxWidth > 0 && cameraImage.cols > config.maxWidth) {
+        const double scale = static_cast<double>(config.maxWidth) / cameraImage.cols;
+        cv::resize(cameraImage, scaledFrame, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    else {
+        cameraImage.copyTo(scaledFrame);
+    }
+
+    // Single conversion into the reused display image, so the overlay never touches the camera buffer
+    if (scaledFrame.channels() == 1) {
+        cv::cvtColor(scaledFrame, displayFrame, cv::COLOR_GRAY2BGR);
+    }
+    else if (scaledFrame.channels() == 4) {
+        cv::cvtColor(scaledFrame, displayFrame, cv::COLOR_BGRA2BGR);
+    }
+    else if (inspected.frame->image.format == FramePixelFormat::RGB8) {
+        cv::cvtColor(scaledFrame, displayFrame, cv::COLOR_RGB2BGR);
+    }
+    else {
+        std::swap(scaledFrame, displayFrame);
+    }
+
+    // The verdict belongs to exactly this frame
+    static const std::string okText = "OK";
+    static const std::string nokText = "NOK";
+    const std::string& statusText = inspected.result.ok ? okText : nokText;
+    const cv::Scalar color = inspected.result.ok ? cv::Scalar(0, 255, 0) : cv::Scalar(0, 0, 255);
+
+    const int fontFace = cv::FONT_HERSHEY_SIMPLEX;
+    const double fontScale = 1.5;
+    const int thickness = 3;
+    const cv::Point textPosition(30, 50);
+
+    // Add background for better text visibility
+    cv::Size textSize = cv::getTextSize(statusText, fontFace, fontScale, thickness, nullptr);
+    cv::rectangle(displayFrame,
+        textPosition - cv::Point(10, textSize.height + 5),
+        textPosition + cv::Point(textSize.width + 10, 10),
+        cv::Scalar(0, 0, 0), -1);
+    cv::putText(displayFrame, statusText, textPosition, fontFace, fontScale, color, thickness);
+
+    cv::imshow(config.windowName, displayFrame);
+}
+
+void FrameViewer::run(KeyHandler onKey, IdleHandler onIdle) {
+    cv::namedWindow(config.windowName, cv::WINDOW_NORMAL);
+    {
+        cv::Mat waitingImage = cv::Mat::zeros(480, 640, CV_8UC3);
+        cv::putText(waitingImage, "Waiting for frames...", cv::Point(50, 240),
+            cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(255, 255, 255), 2);
+        cv::imshow(config.windowName, waitingImage);
+    }
+
+    // waitKey() both paces the loop and pumps the window events
+    const int intervalMs = std::max(1, static_cast<int>(1000.0 / (config.maxFps > 0.0 ? config.maxFps : 1000.0)));
+    InspectedFrame current;
+    running = true;
+
+    while (running) {
+        if (latest.take(current)) {
+            const uint64_t hostTimestampNs = current.frame->hostTimestampNs;
+            render(current);
+            // Hand the buffer back to the sink right away
+            current.frame.reset();
+
+            const uint64_t shownNs = steadyNowNs();
+            if (displayLatency) {
+                displayLatency->recordInterval(hostTimestampNs, shownNs);
+            }
+            if (publishToDisplay) {
+                publishToDisplay->recordInterval(current.result.publishNs, shownNs);
+            }
+        }
+
+        if (onIdle) {
+            onIdle();
+        }
+
+        const int key = cv::waitKey(intervalMs) & 0xFF;
+        if (key == 27) { // ESC
+            break;
+        }
+        if (key != 0xFF && onKey && !onKey(key)) {
+            break;
+        }
+    }
+
+    running = false;
+    cv::destroyWindow(config.windowName);
+    // Do not keep a sink buffer after the viewer is closed
+    latest.take(current);
+}
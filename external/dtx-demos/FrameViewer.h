@@ -0,0 +1,64 @@
+#ifndef FRAMEVIEWER_H
+#define FRAMEVIEWER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <opencv2/core.hpp>
+
+#include "InspectionResult.h"
+#include "LatencyHistogram.h"
+#include "LatestSlot.h"
+
+struct ViewerConfig {
+    std::string windowName = "Camera Feed";
+    double maxFps = 15.0; // Frames shown per second at most
+    int maxWidth = 960;   // Frames are downsampled to this width before the overlay is drawn
+};
+
+// Optional live view of an inspection stream. publish() is called from the result
+// callback and only keeps the latest frame (and only as often as it can be shown),
+// so the viewer never slows down acquisition or inspection. run() owns the HighGUI
+// window and has to be called from one thread, usually main.
+class FrameViewer {
+public:
+    // Called with every key pressed in a viewer window; return false to close the viewer
+    using KeyHandler = std::function<bool(int key)>;
+    // Called once per viewer iteration, e.g. to refresh another window
+    using IdleHandler = std::function<void()>;
+
+private:
+    ViewerConfig config;
+    LatestSlot<InspectedFrame> latest;
+    std::atomic<uint64_t> nextAcceptNs{ 0 };
+    std::atomic<bool> running{ false };
+
+    // Reused between frames
+    cv::Mat scaledFrame;
+    cv::Mat displayFrame;
+
+    LatencyHistogram* displayLatency = nullptr;   // Sink pop -> shown
+    LatencyHistogram* publishToDisplay = nullptr; // Result published -> shown
+
+    void render(const InspectedFrame& inspected);
+
+public:
+    explicit FrameViewer(const ViewerConfig& config = ViewerConfig());
+
+    // Offer a result with its frame; dropped if the viewer is not due for a new frame yet
+    void publish(const InspectedFrame& inspected);
+
+    // Show frames until ESC is pressed, a key handler returns false or stop() is called
+    void run(KeyHandler onKey = nullptr, IdleHandler onIdle = nullptr);
+    // Ask run() to return (any thread)
+    void stop() { running = false; }
+
+    // Record display latencies (call before run()); either may be null
+    void setLatencyHistograms(LatencyHistogram* display, LatencyHistogram* fromPublish) {
+        displayLatency = display;
+        publishToDisplay = fromPublish;
+    }
+};
+
+#endif // FRAMEVIEWER_H
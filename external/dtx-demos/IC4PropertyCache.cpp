@@ -0,0 +1,157 @@
+#include "IC4PropertyCache.h"
+
+void IC4PropertyCache::resolve(ic4::PropertyMap map) {
+    // Missing properties are not an error here, they only fail when set
+    ic4::Error& ignore = ic4::Error::Ignore();
+    exposureTime = map.find(ic4::PropId::ExposureTime, ignore);
+    exposureAuto = map.find(ic4::PropId::ExposureAuto, ignore);
+    gain = map.find(ic4::PropId::Gain, ignore);
+    gainAuto = map.find(ic4::PropId::GainAuto, ignore);
+
+    width = map.find(ic4::PropId::Width, ignore);
+    height = map.find(ic4::PropId::Height, ignore);
+    offsetX = map.find(ic4::PropId::OffsetX, ignore);
+    offsetY = map.find(ic4::PropId::OffsetY, ignore);
+
+    triggerMode = map.find(ic4::PropId::TriggerMode, ignore);
+    triggerSelector = map.find(ic4::PropId::TriggerSelector, ignore);
+    triggerSource = map.find(ic4::PropId::TriggerSource, ignore);
+    triggerDelay = map.find(ic4::PropId::TriggerDelay, ignore);
+    triggerSoftware = map.find(ic4::PropId::TriggerSoftware, ignore);
+
+    exposureMin = 0.0;
+    exposureMax = 0.0;
+    if (exposureTime.is_valid()) {
+        exposureMin = exposureTime.minimum(ignore);
+        exposureMax = exposureTime.maximum(ignore);
+    }
+}
+
+void IC4PropertyCache::clear() {
+    *this = IC4PropertyCache();
+}
+
+bool IC4PropertyCache::setFloat(ic4::PropFloat& prop, double value, std::string& error) {
+    if (!prop.is_valid()) {
+        error = "Property not supported by the device";
+        return false;
+    }
+    ic4::Error err;
+    if (!prop.setValue(value, err)) {
+        error = err.message();
+        return false;
+    }
+    return true;
+}
+
+bool IC4PropertyCache::setInteger(ic4::PropInteger& prop, int64_t value, std::string& error) {
+    if (!prop.is_valid()) {
+        error = "Property not supported by the device";
+        return false;
+    }
+    ic4::Error err;
+    if (!prop.setValue(value, err)) {
+        error = err.message();
+        return false;
+    }
+    return true;
+}
+
+bool IC4PropertyCache::setEnumeration(ic4::PropEnumeration& prop, const std::string& value, std::string& error) {
+    if (!prop.is_valid()) {
+        error = "Property not supported by the device";
+        return false;
+    }
+    ic4::Error err;
+    if (!prop.setValue(value, err)) {
+        error = err.message();
+        return false;
+    }
+    return true;
+}
+
+bool IC4PropertyCache::execute(ic4::PropCommand& prop, std::string& error) {
+    if (!prop.is_valid()) {
+        error = "Command not supported by the device";
+        return false;
+    }
+    ic4::Error err;
+    if (!prop.execute(err)) {
+        error = err.message();
+        return false;
+    }
+    return true;
+}
+
+bool IC4PropertyCache::apply(const CameraProfile& profile, std::string& error) {
+    bool ok = true;
+    std::string stepError;
+    // Keep the first failure, but still try the remaining fields
+    auto check = [&](bool stepOk, const char* what) {
+        if (!stepOk && ok) {
+            error = std::string(what) + ": " + stepError;
+            ok = false;
+        }
+    };
+
+    if (profile.exposureUs >= 0.0) {
+        setEnumeration(exposureAuto, "Off", stepError);
+        check(setFloat(exposureTime, profile.exposureUs, stepError), "ExposureTime");
+    }
+    if (profile.gainDb >= 0.0) {
+        setEnumeration(gainAuto, "Off", stepError);
+        check(setFloat(gain, profile.gainDb, stepError), "Gain");
+    }
+
+    // Offsets go to 0 first, so the new size always fits the sensor
+    const bool moveX = profile.offsetX >= 0 || profile.width > 0;
+    const bool moveY = profile.offsetY >= 0 || profile.height > 0;
+    int64_t keepX = 0;
+    int64_t keepY = 0;
+    if (moveX && profile.offsetX < 0 && offsetX.is_valid()) {
+        keepX = offsetX.getValue(ic4::Error::Ignore());
+    }
+    if (moveY && profile.offsetY < 0 && offsetY.is_valid()) {
+        keepY = offsetY.getValue(ic4::Error::Ignore());
+    }
+    if (moveX && offsetX.is_valid()) {
+        setInteger(offsetX, 0, stepError);
+    }
+    if (moveY && offsetY.is_valid()) {
+        setInteger(offsetY, 0, stepError);
+    }
+    if (profile.width > 0) {
+        check(setInteger(width, profile.width, stepError), "Width");
+    }
+    if (profile.height > 0) {
+        check(setInteger(height, profile.height, stepError), "Height");
+    }
+    if (moveX && offsetX.is_valid()) {
+        check(setInteger(offsetX, profile.offsetX >= 0 ? profile.offsetX : keepX, stepError), "OffsetX");
+    }
+    if (moveY && offsetY.is_valid()) {
+        check(setInteger(offsetY, profile.offsetY >= 0 ? profile.offsetY : keepY, stepError), "OffsetY");
+    }
+
+    // The trigger is reconfigured with trigger mode off, then switched to the requested mode
+    const bool retrigger = !profile.triggerSource.empty() || profile.triggerDelayUs >= 0.0;
+    if (retrigger || profile.triggerMode >= 0) {
+        bool wasOn = false;
+        if (profile.triggerMode < 0 && triggerMode.is_valid()) {
+            wasOn = triggerMode.getValue(ic4::Error::Ignore()) == "On";
+        }
+        if (retrigger) {
+            check(setEnumeration(triggerMode, "Off", stepError), "TriggerMode");
+            if (!profile.triggerSource.empty()) {
+                setEnumeration(triggerSelector, "FrameStart", stepError);
+                check(setEnumeration(triggerSource, profile.triggerSource, stepError), "TriggerSource");
+            }
+            if (profile.triggerDelayUs >= 0.0) {
+                check(setFloat(triggerDelay, profile.triggerDelayUs, stepError), "TriggerDelay");
+            }
+        }
+        const bool on = profile.triggerMode >= 0 ? profile.triggerMode != 0 : wasOn;
+        check(setEnumeration(triggerMode, on ? "On" : "Off", stepError), "TriggerMode");
+    }
+    return ok;
+}
@@ -0,0 +1,51 @@
+#ifndef IC4PROPERTYCACHE_H
+#define IC4PROPERTYCACHE_H
+
+#include <ic4/ic4.h>
+#include <string>
+#include "CameraProfile.h"
+
+// Typed handles of the device properties the demos use, resolved once after the device
+// is opened. Setting a value through a handle skips the by-name lookup in the property
+// map, which matters when exposure is adjusted per frame. A property the device does
+// not have stays an invalid handle; every setter reports that as an error.
+//
+// Nothing here throws: failures are returned as false with the message in 'error'.
+struct IC4PropertyCache {
+    ic4::PropFloat exposureTime;
+    ic4::PropEnumeration exposureAuto;
+    ic4::PropFloat gain;
+    ic4::PropEnumeration gainAuto;
+
+    ic4::PropInteger width;
+    ic4::PropInteger height;
+    ic4::PropInteger offsetX;
+    ic4::PropInteger offsetY;
+
+    ic4::PropEnumeration triggerMode;
+    ic4::PropEnumeration triggerSelector;
+    ic4::PropEnumeration triggerSource;
+    ic4::PropFloat triggerDelay;
+    ic4::PropCommand triggerSoftware;
+
+    // Exposure range, read once with the handles
+    double exposureMin = 0.0;
+    double exposureMax = 0.0;
+
+    // Look up every handle in the device's property map
+    void resolve(ic4::PropertyMap map);
+    // Drop the handles (before the device is closed)
+    void clear();
+
+    bool setFloat(ic4::PropFloat& prop, double value, std::string& error);
+    bool setInteger(ic4::PropInteger& prop, int64_t value, std::string& error);
+    bool setEnumeration(ic4::PropEnumeration& prop, const std::string& value, std::string& error);
+    bool execute(ic4::PropCommand& prop, std::string& error);
+
+    // Apply every field the profile sets, in the order the device accepts them: auto modes
+    // before values, offsets cleared before the size grows, trigger mode off while the
+    // trigger is reconfigured. All fields are tried; false if any of them failed.
+    bool apply(const CameraProfile& profile, std::string& error);
+};
+
+#endif // IC4PROPERTYCACHE_H
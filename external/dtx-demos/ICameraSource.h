@@ -0,0 +1,60 @@
+#ifndef ICAMERASOURCE_H
+#define ICAMERASOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "Frame.h"
+
+// Acquisition counters since the stream was started
+struct SourceStatistics {
+    uint64_t delivered = 0;          // Frames handed to the consumer
+    uint64_t deviceUnderruns = 0;    // Frames the device/driver dropped for lack of a buffer
+    uint64_t transmissionErrors = 0; // Frames lost or incomplete on the wire
+    uint64_t sinkUnderruns = 0;      // Frames dropped because every sink buffer was held by a consumer
+    uint64_t sinkIgnored = 0;        // Frames the sink discarded on purpose
+    uint64_t missedTriggers = 0;     // Triggers the camera reported as missed (busy), 0 if it cannot tell
+};
+
+// Anything that delivers frames: a real camera, a simulator or a recording
+class ICameraSource {
+public:
+    // Called on the source's acquisition thread for every frame. Keep it short;
+    // the frame's buffer is unavailable to the source until the handle is released.
+    using FrameCallback = std::function<void(FrameHandle)>;
+
+    virtual ~ICameraSource() = default;
+
+    // Start delivering frames to 'callback'. Does not block.
+    virtual bool startStream(FrameCallback callback) = 0;
+    // Stop delivering frames; no callback runs after this returns
+    virtual bool stopStream() = 0;
+    // Check if frames are being delivered
+    virtual bool streaming() const = 0;
+
+    // Set exposure time in microseconds
+    virtual bool setExposure(double exposureUs) = 0;
+    // Get current exposure value
+    virtual double getExposure() = 0;
+
+    // Short human readable description (model, serial, ...)
+    virtual std::string description() const = 0;
+
+    // Buffers currently held by consumers
+    virtual size_t buffersInFlight() const = 0;
+    // Highest number of buffers held at the same time
+    virtual size_t peakBuffersInFlight() const = 0;
+
+    // Delivered and dropped frame counters
+    virtual SourceStatistics statistics() = 0;
+
+    // One frame per trigger from 'source' ("Software" or "Line1"), 'delay' in microseconds
+    virtual bool configureTrigger(const std::string& source = "Software", double delay = 0.0) = 0;
+    // Back to free-running acquisition
+    virtual bool disableTriggerMode() = 0;
+    // Fire one software trigger; fails unless configured for "Software"
+    virtual bool sendSoftwareTrigger() = 0;
+};
+
+#endif // ICAMERASOURCE_H
@@ -0,0 +1,24 @@
+#ifndef IINSPECTIONENGINE_H
+#define IINSPECTIONENGINE_H
+
+#include <cstdint>
+#include "Frame.h"
+#include "InspectionResult.h"
+
+// Backend that inspects one image and produces an OK/NOK verdict.
+// One instance is used by one thread at a time. Instances may run in parallel on different
+// threads, so a backend whose instances share state (a process-wide solution, a device)
+// has to serialize runOnFrame() across them, or every result may belong to another frame.
+class IInspectionEngine {
+public:
+    virtual ~IInspectionEngine() = default;
+
+    // Inspect the image in place (the pixels are only read). Fills valid/ok/value/outputs of 'result';
+    // sequence and frame number are set by the caller.
+    virtual bool runOnFrame(const ImageView& image, InspectionResult& result) = 0;
+
+    // Number of images that had to be converted before the backend could read them
+    virtual uint64_t conversionFallbackCount() const = 0;
+};
+
+#endif // IINSPECTIONENGINE_H
@@ -0,0 +1,104 @@
+#include "ImageConversion.h"
+#include <cstring>
+
+static bool acceptsFormat(const EngineInputCaps& caps, FramePixelFormat format) {
+    switch (format) {
+    case FramePixelFormat::Mono8: return caps.mono8;
+    case FramePixelFormat::BGR8:  return caps.bgr8;
+    case FramePixelFormat::RGB8:  return caps.rgb8;
+    default:                      return false;
+    }
+}
+
+static bool hasTightRows(const ImageView& image) {
+    return image.stride == static_cast<size_t>(image.width) * bytesPerPixel(image.format);
+}
+
+// Cheapest format the engine accepts for a given source format
+static FramePixelFormat chooseTarget(const EngineInputCaps& caps, FramePixelFormat source) {
+    if (acceptsFormat(caps, source)) {
+        return source; // Only the rows need repacking
+    }
+    if (source == FramePixelFormat::Mono8) {
+        if (caps.bgr8) return FramePixelFormat::BGR8;
+        if (caps.rgb8) return FramePixelFormat::RGB8;
+        return FramePixelFormat::Unknown;
+    }
+    if (caps.bgr8) return FramePixelFormat::BGR8;
+    if (caps.rgb8) return FramePixelFormat::RGB8;
+    if (caps.mono8) return FramePixelFormat::Mono8;
+    return FramePixelFormat::Unknown;
+}
+
+// Read one pixel as B, G, R
+static inline void readPixel(const uint8_t* p, FramePixelFormat format, uint8_t& b, uint8_t& g, uint8_t& r) {
+    switch (format) {
+    case FramePixelFormat::Mono8: b = g = r = p[0]; break;
+    case FramePixelFormat::RGB8:  r = p[0]; g = p[1]; b = p[2]; break;
+    default:                      b = p[0]; g = p[1]; r = p[2]; break; // BGR8, BGRa8
+    }
+}
+
+static inline void writePixel(uint8_t* p, FramePixelFormat format, uint8_t b, uint8_t g, uint8_t r) {
+    switch (format) {
+    case FramePixelFormat::Mono8:
+        // ITU-R BT.601 luma in fixed point
+        p[0] = static_cast<uint8_t>((29 * b + 150 * g + 77 * r + 128) >> 8);
+        break;
+    case FramePixelFormat::RGB8: p[0] = r; p[1] = g; p[2] = b; break;
+    default:                     p[0] = b; p[1] = g; p[2] = r; break; // BGR8
+    }
+}
+
+ImageView prepareEngineInput(const ImageView& image, const EngineInputCaps& caps,
+    std::vector<uint8_t>& scratch, bool& converted) {
+    converted = false;
+
+    if (image.data == nullptr || image.width <= 0 || image.height <= 0 ||
+        image.format == FramePixelFormat::Unknown) {
+        return ImageView();
+    }
+
+    // Fast path: hand the camera buffer over as it is
+    if (acceptsFormat(caps, image.format) && (caps.paddedRows || hasTightRows(image))) {
+        return image;
+    }
+
+    FramePixelFormat target = chooseTarget(caps, image.format);
+    if (target == FramePixelFormat::Unknown) {
+        return ImageView();
+    }
+
+    const int srcBpp = bytesPerPixel(image.format);
+    const int dstBpp = bytesPerPixel(target);
+    const size_t dstStride = static_cast<size_t>(image.width) * dstBpp;
+    const size_t needed = dstStride * image.height;
+    if (scratch.size() < needed) {
+        scratch.resize(needed);
+    }
+
+    for (int y = 0; y < image.height; ++y) {
+        const uint8_t* src = image.data + y * image.stride;
+        uint8_t* dst = scratch.data() + y * dstStride;
+
+        if (target == image.format) {
+            std::memcpy(dst, src, dstStride);
+            continue;
+        }
+        for (int x = 0; x < image.width; ++x) {
+            uint8_t b, g, r;
+            readPixel(src + x * srcBpp, image.format, b, g, r);
+            writePixel(dst + x * dstBpp, target, b, g, r);
+        }
+    }
+
+    converted = true;
+
+    ImageView view;
+    view.data = scratch.data();
+    view.width = image.width;
+    view.height = image.height;
+    view.stride = dstStride;
+    view.format = target;
+    return view;
+}
@@ -0,0 +1,23 @@
+#ifndef IMAGECONVERSION_H
+#define IMAGECONVERSION_H
+
+#include <cstdint>
+#include <vector>
+#include "Frame.h"
+
+// Image layouts an inspection engine can read directly from the camera buffer
+struct EngineInputCaps {
+    bool mono8 = true;
+    bool bgr8 = false;
+    bool rgb8 = false;
+    bool paddedRows = false; // Rows may be longer than width * bytes per pixel
+};
+
+// Return 'image' unchanged if the engine accepts it as-is. Otherwise convert it
+// into 'scratch' (reused between calls, so it only allocates when the size grows),
+// set 'converted' and return a view of the converted pixels.
+// The returned view has format Unknown if no conversion is possible.
+ImageView prepareEngineInput(const ImageView& image, const EngineInputCaps& caps,
+    std::vector<uint8_t>& scratch, bool& converted);
+
+#endif // IMAGECONVERSION_H
@@ -0,0 +1,185 @@
+#include "InspectionPipeline.h"
+#include "Affinity.h"
+#include <iostream>
+
+InspectionPipeline::InspectionPipeline(const PipelineConfig& config, EngineFactory engineFactory,
+    ResultCallback resultCallback)
+    : config(config), engineFactory(std::move(engineFactory)), resultCallback(std::move(resultCallback)),
+    queue(config.queueCapacity, config.policy),
+    reorderSlots(config.reorderWindow > 0 ? config.reorderWindow : 1) {
+}
+
+InspectionPipeline::~InspectionPipeline() {
+    stop();
+    if (metrics) {
+        metrics->removeCounters(metricsCounters);
+    }
+}
+
+void InspectionPipeline::attachMetrics(MetricsRegistry& registry, const std::string& labels) {
+    if (metrics) {
+        metrics->removeCounters(metricsCounters);
+    }
+    metrics = &registry;
+    frameInterval = registry.histogram("dtx_frame_interval_seconds", labels, "Time between device timestamps of consecutive frames");
+    queueWait = registry.histogram("dtx_queue_wait_seconds", labels, "Sink pop to inspection start");
+    inspectTime = registry.histogram("dtx_inspect_seconds", labels, "Inspection start to end");
+    reorderWait = registry.histogram("dtx_reorder_wait_seconds", labels, "Inspection end to result publish");
+    totalLatency = registry.histogram("dtx_pipeline_latency_seconds", labels, "Sink pop to result publish");
+
+    metricsCounters = registry.addCounters([this, labels](std::vector<MetricSample>& samples) {
+        samples.push_back(MetricSample{ "dtx_frames_submitted_total", labels, static_cast<double>(submittedCount()), false });
+        samples.push_back(MetricSample{ "dtx_frames_dropped_total", labels, static_cast<double>(droppedCount()), false });
+        samples.push_back(MetricSample{ "dtx_inspections_failed_total", labels, static_cast<double>(failedCount()), false });
+        samples.push_back(MetricSample{ "dtx_results_published_total", labels, static_cast<double>(publishedCount()), false });
+        samples.push_back(MetricSample{ "dtx_conversion_fallbacks_total", labels, static_cast<double>(conversionFallbackCount()), false });
+        samples.push_back(MetricSample{ "dtx_queue_depth", labels, static_cast<double>(queue.size()), true });
+    });
+}
+
+bool InspectionPipeline::start() {
+    if (running) {
+        return true;
+    }
+    if (config.workerCount == 0) {
+        std::cerr << "Inspection pipeline needs at least one worker." << std::endl;
+        return false;
+    }
+
+    running = true;
+    publisher = std::thread(&InspectionPipeline::publisherLoop, this);
+    for (size_t i = 0; i < config.workerCount; ++i) {
+        workers.emplace_back(&InspectionPipeline::workerLoop, this, i);
+    }
+    return true;
+}
+
+void InspectionPipeline::stop() {
+    if (!running) {
+        return;
+    }
+
+    // Workers drain the queue before they exit
+    queue.close();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(reorderMutex);
+        running = false;
+    }
+    slotReady.notify_all();
+    publisher.join();
+}
+
+bool InspectionPipeline::submit(FrameHandle frame) {
+    FrameHandle droppedFrame;
+
+    ++submitted;
+    if (frameInterval && frame) {
+        if (lastDeviceTimestampNs != 0) {
+            frameInterval->recordInterval(lastDeviceTimestampNs, frame->deviceTimestampNs);
+        }
+        lastDeviceTimestampNs = frame->deviceTimestampNs;
+    }
+    if (queue.push(std::move(frame), droppedFrame) != BoundedQueue<FrameHandle>::PushResult::Queued) {
+        // The dropped frame is released here and its buffer goes back to the sink
+        ++dropped;
+        return false;
+    }
+    return true;
+}
+
+void InspectionPipeline::workerLoop(size_t index) {
+    if (!config.workerCores.empty()) {
+        const int core = config.workerCores[index % config.workerCores.size()];
+        if (!pinCurrentThread(core)) {
+            std::cerr << "Cannot pin inspection worker to core " << core << "." << std::endl;
+        }
+    }
+
+    // Each worker owns its engine object. Engines that share state behind it (VisionMaster
+    // has one solution per process) serialize their runs themselves, see IInspectionEngine.
+    std::unique_ptr<IInspectionEngine> engine = engineFactory ? engineFactory() : nullptr;
+    if (!engine) {
+        std::cerr << "Inspection worker has no engine, results will be invalid." << std::endl;
+    }
+    uint64_t reportedFallbacks = 0;
+
+    FrameHandle frame;
+    uint64_t sequence = 0;
+    while (queue.pop(frame, &sequence)) {
+        InspectedFrame inspected;
+        inspected.result.sequence = sequence;
+        inspected.result.frameNumber = frame ? frame->frameNumber : 0;
+
+        inspected.result.inspectStartNs = steadyNowNs();
+        if (engine && frame) {
+            engine->runOnFrame(frame->image, inspected.result);
+
+            uint64_t fallbacks = engine->conversionFallbackCount();
+            conversionFallbacks += fallbacks - reportedFallbacks;
+            reportedFallbacks = fallbacks;
+        }
+        inspected.result.inspectEndNs = steadyNowNs();
+        if (!inspected.result.valid) {
+            ++failed;
+        }
+        if (queueWait && frame) {
+            queueWait->recordInterval(frame->hostTimestampNs, inspected.result.inspectStartNs);
+            inspectTime->recordInterval(inspected.result.inspectStartNs, inspected.result.inspectEndNs);
+        }
+
+        inspected.frame = std::move(frame);
+        complete(std::move(inspected));
+    }
+}
+
+void InspectionPipeline::complete(InspectedFrame&& inspected) {
+    const uint64_t sequence = inspected.result.sequence;
+    {
+        std::unique_lock<std::mutex> lock(reorderMutex);
+        // Bound the results waiting behind a slow one; this backs up into the queue.
+        // The oldest outstanding sequence never waits, so this cannot deadlock.
+        slotFreed.wait(lock, [&] { return sequence < nextToPublish + reorderSlots.size(); });
+        Slot& slot = reorderSlots[sequence % reorderSlots.size()];
+        slot.done = true;
+        slot.inspected = std::move(inspected);
+    }
+    slotReady.notify_one();
+}
+
+void InspectionPipeline::publisherLoop() {
+    while (true) {
+        InspectedFrame inspected;
+        {
+            std::unique_lock<std::mutex> lock(reorderMutex);
+            Slot* slot = &reorderSlots[nextToPublish % reorderSlots.size()];
+            slotReady.wait(lock, [&] { return slot->done || !running; });
+            if (!slot->done) {
+                // Stopped and every inspected frame has been published
+                return;
+            }
+            inspected = std::move(slot->inspected);
+            slot->inspected = InspectedFrame();
+            slot->done = false;
+            ++nextToPublish;
+        }
+        slotFreed.notify_all();
+
+        inspected.result.publishNs = steadyNowNs();
+        if (reorderWait) {
+            reorderWait->recordInterval(inspected.result.inspectEndNs, inspected.result.publishNs);
+            if (inspected.frame) {
+                totalLatency->recordInterval(inspected.frame->hostTimestampNs, inspected.result.publishNs);
+            }
+        }
+
+        if (resultCallback) {
+            resultCallback(inspected);
+        }
+        ++published;
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef INSPECTIONPIPELINE_H
+#define INSPECTIONPIPELINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "Frame.h"
+#include "IInspectionEngine.h"
+#include "InspectionResult.h"
+#include "MetricsRegistry.h"
+
+struct PipelineConfig {
+    size_t workerCount = 2;   // Inspection workers, each with its own engine object
+    size_t queueCapacity = 4; // Frames waiting for a worker
+    BackpressurePolicy policy = BackpressurePolicy::DropOldest;
+    size_t reorderWindow = 16; // Finished results that may wait for an older, slower one
+    std::vector<int> workerCores; // Pin worker i to workerCores[i % size], empty = no pinning
+};
+
+// Acquire -> bounded queue -> N inspection workers -> in-order result stage.
+// submit() never runs an inspection, so a slow procedure does not stall buffer popping.
+// Frames are numbered when a worker takes them from the queue (dropped frames get no
+// number) and results are published in that order, which is the submission order.
+class InspectionPipeline {
+public:
+    using EngineFactory = std::function<std::unique_ptr<IInspectionEngine>()>;
+    using ResultCallback = std::function<void(const InspectedFrame&)>;
+
+private:
+    struct Slot {
+        bool done = false;
+        InspectedFrame inspected;
+    };
+
+    PipelineConfig config;
+    EngineFactory engineFactory;
+    ResultCallback resultCallback;
+
+    BoundedQueue<FrameHandle> queue;
+    std::vector<std::thread> workers;
+    std::thread publisher;
+
+    // Reorder stage, indexed by sequence modulo size
+    std::mutex reorderMutex;
+    std::condition_variable slotReady;
+    std::condition_variable slotFreed;
+    std::vector<Slot> reorderSlots;
+    uint64_t nextToPublish = 0;
+    bool running = false;
+
+    std::atomic<uint64_t> submitted{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> failed{ 0 };
+    std::atomic<uint64_t> published{ 0 };
+    std::atomic<uint64_t> conversionFallbacks{ 0 };
+
+    // Stage latencies, null until attachMetrics()
+    MetricsRegistry* metrics = nullptr;
+    int metricsCounters = 0;
+    LatencyHistogram* frameInterval = nullptr; // Between device timestamps of submitted frames
+    LatencyHistogram* queueWait = nullptr;     // Sink pop -> inspection start
+    LatencyHistogram* inspectTime = nullptr;   // Inspection start -> end
+    LatencyHistogram* reorderWait = nullptr;   // Inspection end -> publish
+    LatencyHistogram* totalLatency = nullptr;  // Sink pop -> publish
+    uint64_t lastDeviceTimestampNs = 0;
+
+    void workerLoop(size_t index);
+    void publisherLoop();
+    // Hand a finished inspection to the reorder stage
+    void complete(InspectedFrame&& inspected);
+
+public:
+    InspectionPipeline(const PipelineConfig& config, EngineFactory engineFactory, ResultCallback resultCallback);
+    ~InspectionPipeline();
+
+    InspectionPipeline(const InspectionPipeline&) = delete;
+    InspectionPipeline& operator=(const InspectionPipeline&) = delete;
+
+    // Record stage latencies and counters in 'registry' under 'labels' (e.g. camera="123").
+    // Call before start(); the registry has to outlive the pipeline.
+    void attachMetrics(MetricsRegistry& registry, const std::string& labels = "");
+
+    // Start the worker and publisher threads
+    bool start();
+    // Finish queued frames and join all threads
+    void stop();
+    // Queue a frame for inspection (single producer). Returns false if a frame was dropped.
+    bool submit(FrameHandle frame);
+
+    uint64_t submittedCount() const { return submitted.load(); }
+    uint64_t droppedCount() const { return dropped.load(); }
+    uint64_t failedCount() const { return failed.load(); }
+    uint64_t publishedCount() const { return published.load(); }
+    // Frames the engines had to convert before inspecting them
+    uint64_t conversionFallbackCount() const { return conversionFallbacks.load(); }
+};
+
+#endif // INSPECTIONPIPELINE_H
@@ -0,0 +1,81 @@
+#ifndef INSPECTIONRESULT_H
+#define INSPECTIONRESULT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Frame.h"
+
+// Every numeric output of one inspection run (VisionMaster: all parameters of the
+// Variable Calculation result), flattened in parameter order. Every parameter keeps its
+// index, also one without values (Empty), since readers tell them apart by position only.
+// Fixed size, so results can be copied and stored without allocating.
+struct ResultValues {
+    enum : uint32_t { MaxParams = 8, MaxValues = 32 };
+    enum ParamType : uint8_t { Empty = 0, Int = 1, Float = 2 };
+
+    uint32_t paramCount = 0;
+    uint32_t valueCount = 0;
+    bool truncated = false;             // Parameters or values beyond the limits were left out
+    uint8_t paramTypes[MaxParams] = {};
+    uint8_t paramSizes[MaxParams] = {}; // Values per parameter
+    double values[MaxValues] = {};
+
+    void clear() {
+        paramCount = 0;
+        valueCount = 0;
+        truncated = false;
+    }
+
+    // Append one parameter; values that do not fit are dropped and flagged
+    template <typename T>
+    void add(ParamType type, const T* data, size_t count) {
+        if (paramCount >= MaxParams) {
+            truncated = true;
+            return;
+        }
+        size_t stored = 0;
+        for (; stored < count && valueCount < MaxValues; ++stored) {
+            values[valueCount++] = static_cast<double>(data[stored]);
+        }
+        truncated = truncated || stored < count;
+        paramTypes[paramCount] = type;
+        paramSizes[paramCount] = static_cast<uint8_t>(stored);
+        ++paramCount;
+    }
+
+    // Append a parameter without values, so the ones after it keep their index.
+    // 'unsupported': it had values of a type that is not stored, flagged as truncated.
+    void addEmpty(bool unsupported) {
+        if (paramCount >= MaxParams) {
+            truncated = true;
+            return;
+        }
+        truncated = truncated || unsupported;
+        paramTypes[paramCount] = Empty;
+        paramSizes[paramCount] = 0;
+        ++paramCount;
+    }
+};
+
+// Verdict of one inspection run
+struct InspectionResult {
+    uint64_t sequence = 0;    // Order in which the frame was taken up by the pipeline
+    uint64_t frameNumber = 0; // Device frame number of the inspected frame
+    bool valid = false;       // False if the inspection could not be run
+    bool ok = false;          // OK/NOK verdict
+    float value = 0.0f;       // Raw value the verdict is derived from
+    ResultValues outputs;     // All outputs of the run, including 'value'
+
+    // Stage timestamps, steadyNowNs()
+    uint64_t inspectStartNs = 0;
+    uint64_t inspectEndNs = 0;
+    uint64_t publishNs = 0;
+};
+
+// A frame together with the result computed from it
+struct InspectedFrame {
+    FrameHandle frame;
+    InspectionResult result;
+};
+
+#endif // INSPECTIONRESULT_H
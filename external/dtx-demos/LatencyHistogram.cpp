@@ -0,0 +1,94 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+
+// Each thread sticks to one shard, assigned round-robin on first use
+static size_t currentShard() {
+    static std::atomic<size_t> nextShard{ 0 };
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % LatencyHistogram::kShardCount;
+    return shard;
+}
+
+static int highestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : shards(new Shard[kShardCount]) {
+    for (size_t s = 0; s < kShardCount; ++s) {
+        for (auto& bucket : shards[s].buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        shards[s].count.store(0, std::memory_order_relaxed);
+        shards[s].sum.store(0, std::memory_order_relaxed);
+        shards[s].max.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t valueNs) {
+    const uint64_t limit = (uint64_t(1) << (kMaxBit + 1)) - 1;
+    valueNs = std::min(valueNs, limit);
+    if (valueNs < 2 * kSubBuckets) {
+        return static_cast<size_t>(valueNs);
+    }
+    const int exponent = highestBit(valueNs) - kSubBucketBits;
+    return static_cast<size_t>((exponent + 1) * kSubBuckets + ((valueNs >> exponent) - kSubBuckets));
+}
+
+uint64_t LatencyHistogram::bucketValue(size_t index) {
+    if (index < 2 * kSubBuckets) {
+        return index;
+    }
+    const int exponent = static_cast<int>(index / kSubBuckets) - 1;
+    const uint64_t mantissa = index % kSubBuckets + kSubBuckets;
+    // Middle of the bucket's range
+    return (mantissa << exponent) + ((uint64_t(1) << exponent) >> 1);
+}
+
+void LatencyHistogram::record(uint64_t valueNs) {
+    Shard& shard = shards[currentShard()];
+    shard.buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(valueNs, std::memory_order_relaxed);
+
+    uint64_t max = shard.max.load(std::memory_order_relaxed);
+    while (valueNs > max && !shard.max.compare_exchange_weak(max, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot snap;
+    snap.counts.assign(kBucketCount, 0);
+    for (size_t s = 0; s < kShardCount; ++s) {
+        const Shard& shard = shards[s];
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            snap.counts[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        snap.sum += shard.sum.load(std::memory_order_relaxed);
+        snap.max = std::max(snap.max, shard.max.load(std::memory_order_relaxed));
+    }
+    // Count from the buckets, so percentiles stay consistent with a concurrent record()
+    for (uint64_t c : snap.counts) {
+        snap.count += c;
+    }
+    return snap;
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * count + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(LatencyHistogram::bucketValue(i), max);
+        }
+    }
+    return max;
+}
@@ -0,0 +1,62 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Merged view of a LatencyHistogram at one point in time
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t sum = 0; // Nanoseconds
+    uint64_t max = 0; // Nanoseconds
+
+    // Value (ns) at quantile q in [0, 1], 0 if empty
+    uint64_t percentile(double q) const;
+    double mean() const { return count > 0 ? static_cast<double>(sum) / count : 0.0; }
+};
+
+// HDR-style latency histogram in nanoseconds: log-linear buckets with 32 sub-buckets
+// per power of two (about 3% relative error), values above ~36 minutes are clamped.
+// record() is lock-free: each thread writes into one of kShardCount shards (assigned
+// round-robin per thread) with relaxed atomics, and snapshot() merges the shards.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = 1u << kSubBucketBits;
+    static constexpr int kMaxBit = 40;
+    static constexpr size_t kBucketCount = (kMaxBit - kSubBucketBits + 2) * kSubBuckets;
+    static constexpr size_t kShardCount = 8;
+
+    LatencyHistogram();
+
+    // Record one duration in nanoseconds
+    void record(uint64_t valueNs);
+    // Record the time between two steadyNowNs() timestamps; ignored if either is missing
+    void recordInterval(uint64_t startNs, uint64_t endNs) {
+        if (startNs != 0 && endNs >= startNs) {
+            record(endNs - startNs);
+        }
+    }
+
+    HistogramSnapshot snapshot() const;
+
+    // Bucket index of a value and the representative value (ns) of a bucket
+    static size_t bucketIndex(uint64_t valueNs);
+    static uint64_t bucketValue(size_t index);
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> buckets[kBucketCount];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,50 @@
+#ifndef LATESTSLOT_H
+#define LATESTSLOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+// Lock-free "latest value" slot for one producer and one consumer (triple buffer).
+// The producer never waits for the consumer; values the consumer did not take
+// in time are released on the producer side when they are superseded.
+template <typename T>
+class LatestSlot {
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kDirty = 0x4;
+
+    T slots[3];
+    std::atomic<uint8_t> middle{ 1 }; // Index of the shared slot, plus kDirty when it holds a new value
+    uint8_t back = 0;                 // Owned by the producer
+    uint8_t front = 2;                // Owned by the consumer
+
+public:
+    // Producer: publish a new value
+    void publish(T value) {
+        slots[back] = std::move(value);
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(back | kDirty), std::memory_order_acq_rel);
+        back = previous & kIndexMask;
+        // Drop whatever the consumer skipped (or already moved out) right away
+        slots[back] = T();
+    }
+
+    // Consumer: move out the most recent value. Returns false if nothing new was published.
+    bool take(T& out) {
+        if ((middle.load(std::memory_order_acquire) & kDirty) == 0) {
+            return false;
+        }
+        uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & kIndexMask;
+        out = std::move(slots[front]);
+        slots[front] = T();
+        return true;
+    }
+
+    // Consumer: check if a value was published since the last take()
+    bool hasNew() const {
+        return (middle.load(std::memory_order_acquire) & kDirty) != 0;
+    }
+};
+
+#endif // LATESTSLOT_H
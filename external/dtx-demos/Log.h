@@ -0,0 +1,52 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <iostream>
+
+// Console log levels for per-frame messages. Setup and error messages that
+// happen once per run keep writing to std::cout/std::cerr directly.
+enum class LogLevel {
+    Off = 0,
+    Error,
+    Warning,
+    Info,
+    Debug
+};
+
+// Highest level compiled in. Statements above it are removed entirely, e.g.
+// build with DTX_LOG_MAX_LEVEL=1 to keep only errors on the hot path.
+#ifndef DTX_LOG_MAX_LEVEL
+#define DTX_LOG_MAX_LEVEL 4
+#endif
+
+inline std::atomic<int>& logLevelStorage() {
+    static std::atomic<int> level{ static_cast<int>(LogLevel::Info) };
+    return level;
+}
+
+// Runtime log level (default Info), may be changed from any thread
+inline void setLogLevel(LogLevel level) {
+    logLevelStorage().store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+inline LogLevel logLevel() {
+    return static_cast<LogLevel>(logLevelStorage().load(std::memory_order_relaxed));
+}
+
+inline bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) <= DTX_LOG_MAX_LEVEL &&
+        static_cast<int>(level) <= logLevelStorage().load(std::memory_order_relaxed);
+}
+
+// DTX_LOG(Debug, "Frame " << n << " done"); the message is only formatted if the level is enabled.
+// Errors and warnings go to std::cerr, everything else to std::cout.
+#define DTX_LOG(level, message) \
+    do { \
+        if (logEnabled(LogLevel::level)) { \
+            (static_cast<int>(LogLevel::level) <= static_cast<int>(LogLevel::Warning) ? std::cerr : std::cout) \
+                << message << std::endl; \
+        } \
+    } while (0)
+
+#endif // LOG_H
@@ -0,0 +1,209 @@
+#include "MetricsExporter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+using SocketHandle = SOCKET;
+static const SocketHandle kInvalidSocket = INVALID_SOCKET;
+static void closeSocket(SocketHandle s) { closesocket(s); }
+static const int kSendFlags = 0;
+// Bound every recv/send on a client, so an idle client cannot stall the server thread
+static void setSocketTimeouts(SocketHandle s, int ms) {
+    DWORD timeout = static_cast<DWORD>(ms);
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SocketHandle = int;
+static const SocketHandle kInvalidSocket = -1;
+static void closeSocket(SocketHandle s) { close(s); }
+// A scraper that disconnects mid-response must not kill the process with SIGPIPE
+#ifdef MSG_NOSIGNAL
+static const int kSendFlags = MSG_NOSIGNAL;
+#else
+static const int kSendFlags = 0;
+#endif
+static void setSocketTimeouts(SocketHandle s, int ms) {
+    timeval timeout{ ms / 1000, (ms % 1000) * 1000 };
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1;
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+}
+#endif
+
+MetricsExporter::MetricsExporter(MetricsRegistry& registry, const MetricsExporterConfig& config)
+    : registry(registry), config(config) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    if (running) {
+        return true;
+    }
+    if (config.httpPort > 0 && !openListenSocket()) {
+        return false;
+    }
+
+    running = true;
+    if (config.httpPort > 0) {
+        httpThread = std::thread(&MetricsExporter::httpLoop, this);
+        std::cout << "Metrics on http://127.0.0.1:" << config.httpPort << "/metrics" << std::endl;
+    }
+    if (!config.dumpPath.empty()) {
+        dumpThread = std::thread(&MetricsExporter::dumpLoop, this);
+    }
+    return true;
+}
+
+void MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    dumpWake.notify_all();
+    if (listenSocket != -1) {
+        // Refuse new clients right away; the server thread sees 'running' within its select timeout
+        shutdown(static_cast<SocketHandle>(listenSocket), 2);
+    }
+    if (httpThread.joinable()) {
+        httpThread.join();
+    }
+    if (dumpThread.joinable()) {
+        dumpThread.join();
+    }
+    closeListenSocket();
+}
+
+bool MetricsExporter::writeFile(const MetricsRegistry& registry, const std::string& path) {
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Cannot write metrics file " << tempPath << std::endl;
+            return false;
+        }
+        file << registry.prometheusText();
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+bool MetricsExporter::openListenSocket() {
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "WSAStartup failed." << std::endl;
+        return false;
+    }
+#endif
+    SocketHandle s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == kInvalidSocket) {
+        std::cerr << "Cannot create metrics socket." << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    // Local only; scrape through a reverse proxy if it has to leave the line PC
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(config.httpPort));
+
+    if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(s, 4) != 0) {
+        std::cerr << "Cannot listen for metrics on port " << config.httpPort << "." << std::endl;
+        closeSocket(s);
+        return false;
+    }
+    listenSocket = static_cast<intptr_t>(s);
+    return true;
+}
+
+void MetricsExporter::closeListenSocket() {
+    if (listenSocket == -1) {
+        return;
+    }
+    closeSocket(static_cast<SocketHandle>(listenSocket));
+    listenSocket = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void MetricsExporter::httpLoop() {
+    const SocketHandle server = static_cast<SocketHandle>(listenSocket);
+
+    while (running) {
+        // Wake up regularly to notice stop()
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(server, &readSet);
+        timeval timeout{ 0, 200000 };
+        if (select(static_cast<int>(server) + 1, &readSet, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+
+        SocketHandle client = accept(server, nullptr, nullptr);
+        if (client == kInvalidSocket) {
+            continue;
+        }
+        setSocketTimeouts(client, 1000);
+
+        // Every request gets the metrics, whatever the path; Prometheus only sends GETs
+        char request[1024];
+        recv(client, request, sizeof(request), 0);
+
+        const std::string body = registry.prometheusText();
+        const std::string response =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+
+        size_t sent = 0;
+        while (sent < response.size()) {
+            int n = send(client, response.data() + sent, static_cast<int>(response.size() - sent), kSendFlags);
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        closeSocket(client);
+    }
+}
+
+void MetricsExporter::dumpLoop() {
+    const auto interval = std::chrono::duration<double>(config.dumpIntervalSec > 0.0 ? config.dumpIntervalSec : 1.0);
+
+    std::unique_lock<std::mutex> lock(dumpMutex);
+    while (running) {
+        dumpWake.wait_for(lock, interval, [this] { return !running; });
+        lock.unlock();
+        writeFile(registry, config.dumpPath);
+        lock.lock();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "MetricsRegistry.h"
+
+struct MetricsExporterConfig {
+    int httpPort = 0;            // Serve Prometheus text on http://127.0.0.1:<port>/metrics, 0 = off
+    std::string dumpPath;        // Rewrite this file with the Prometheus text periodically, empty = off
+    double dumpIntervalSec = 5.0;
+};
+
+// Exposes a MetricsRegistry outside the process, on its own threads so neither
+// a scrape nor a file write ever runs on the acquisition or inspection path.
+class MetricsExporter {
+private:
+    MetricsRegistry& registry;
+    MetricsExporterConfig config;
+
+    std::thread httpThread;
+    std::thread dumpThread;
+    std::atomic<bool> running{ false };
+    std::mutex dumpMutex;
+    std::condition_variable dumpWake;
+
+    // Platform socket handle, stored as integer (SOCKET on Windows, int elsewhere)
+    intptr_t listenSocket = -1;
+
+    bool openListenSocket();
+    void closeListenSocket();
+    void httpLoop();
+    void dumpLoop();
+
+public:
+    MetricsExporter(MetricsRegistry& registry, const MetricsExporterConfig& config);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool start();
+    // Stops the server and writes the dump file one last time
+    void stop();
+
+    // Write the current metrics to 'path' (via a temporary file, so readers never see half a dump)
+    static bool writeFile(const MetricsRegistry& registry, const std::string& path);
+};
+
+#endif // METRICSEXPORTER_H
@@ -0,0 +1,121 @@
+#include "MetricsRegistry.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+static const double kQuantiles[] = { 0.5, 0.99, 0.999 };
+
+static std::string withLabels(const std::string& name, const std::string& labels, const std::string& extra = "") {
+    std::string all = labels;
+    if (!extra.empty()) {
+        all += all.empty() ? extra : "," + extra;
+    }
+    return all.empty() ? name : name + "{" + all + "}";
+}
+
+// Stable order of 'items' that keeps every name in one block, blocks in order of first appearance.
+// The exposition format needs each metric family contiguous, under a single HELP/TYPE.
+template <typename T, typename NameOf>
+static std::vector<const T*> groupByName(const std::vector<T>& items, NameOf nameOf) {
+    std::map<std::string, size_t> firstSeen;
+    std::vector<const T*> grouped;
+    grouped.reserve(items.size());
+    for (const T& item : items) {
+        firstSeen.emplace(nameOf(item), firstSeen.size());
+        grouped.push_back(&item);
+    }
+    std::stable_sort(grouped.begin(), grouped.end(), [&](const T* a, const T* b) {
+        return firstSeen[nameOf(*a)] < firstSeen[nameOf(*b)];
+    });
+    return grouped;
+}
+
+LatencyHistogram* MetricsRegistry::histogram(const std::string& name, const std::string& labels, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : histograms) {
+        if (entry.name == name && entry.labels == labels) {
+            return entry.histogram.get();
+        }
+    }
+    histograms.push_back(HistogramEntry{ name, labels, help, std::unique_ptr<LatencyHistogram>(new LatencyHistogram()) });
+    return histograms.back().histogram.get();
+}
+
+int MetricsRegistry::addCounters(CounterProvider provider) {
+    std::lock_guard<std::mutex> lock(mutex);
+    providers.push_back(ProviderEntry{ nextProviderId, std::move(provider) });
+    return nextProviderId++;
+}
+
+void MetricsRegistry::removeCounters(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    providers.erase(std::remove_if(providers.begin(), providers.end(),
+        [id](const ProviderEntry& entry) { return entry.id == id; }), providers.end());
+}
+
+std::string MetricsRegistry::prometheusText() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    const std::string* family = nullptr;
+    for (const HistogramEntry* grouped : groupByName(histograms, [](const HistogramEntry& e) { return e.name; })) {
+        const HistogramEntry& entry = *grouped;
+        if (family == nullptr || *family != entry.name) {
+            family = &entry.name;
+            if (!entry.help.empty()) {
+                out << "# HELP " << entry.name << " " << entry.help << "\n";
+            }
+            out << "# TYPE " << entry.name << " summary\n";
+        }
+        const HistogramSnapshot snap = entry.histogram->snapshot();
+        for (double q : kQuantiles) {
+            std::ostringstream quantile;
+            quantile << "quantile=\"" << q << "\"";
+            out << withLabels(entry.name, entry.labels, quantile.str()) << " " << snap.percentile(q) * 1e-9 << "\n";
+        }
+        out << withLabels(entry.name + "_sum", entry.labels) << " " << snap.sum * 1e-9 << "\n";
+        out << withLabels(entry.name + "_count", entry.labels) << " " << snap.count << "\n";
+    }
+
+    std::vector<MetricSample> samples;
+    for (const auto& entry : providers) {
+        entry.provider(samples);
+    }
+    family = nullptr;
+    for (const MetricSample* grouped : groupByName(samples, [](const MetricSample& s) { return s.name; })) {
+        const MetricSample& sample = *grouped;
+        if (family == nullptr || *family != sample.name) {
+            family = &sample.name;
+            out << "# TYPE " << sample.name << (sample.gauge ? " gauge\n" : " counter\n");
+        }
+        out << withLabels(sample.name, sample.labels) << " " << sample.value << "\n";
+    }
+    return out.str();
+}
+
+std::string MetricsRegistry::reportText() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+
+    for (const auto& entry : histograms) {
+        const HistogramSnapshot snap = entry.histogram->snapshot();
+        out << withLabels(entry.name, entry.labels) << ": n=" << snap.count
+            << " p50=" << snap.percentile(0.5) * 1e-6 << "ms"
+            << " p99=" << snap.percentile(0.99) * 1e-6 << "ms"
+            << " p999=" << snap.percentile(0.999) * 1e-6 << "ms"
+            << " max=" << snap.max * 1e-6 << "ms\n";
+    }
+
+    std::vector<MetricSample> samples;
+    for (const auto& entry : providers) {
+        entry.provider(samples);
+    }
+    out << std::setprecision(0);
+    for (const auto& sample : samples) {
+        out << withLabels(sample.name, sample.labels) << ": " << sample.value << "\n";
+    }
+    return out.str();
+}
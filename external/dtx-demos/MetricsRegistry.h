@@ -0,0 +1,61 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+// One counter or gauge value reported by a provider
+struct MetricSample {
+    std::string name;   // Prometheus metric name, e.g. "dtx_frames_dropped_total"
+    std::string labels; // Label list without braces, e.g. "camera=\"12345\"", may be empty
+    double value = 0.0;
+    bool gauge = false; // Counter otherwise
+};
+
+// Collects latency histograms and counter providers and renders them as
+// Prometheus text or a plain report. Histograms are owned by the registry and
+// stay valid for its lifetime; recording into them never takes a lock.
+class MetricsRegistry {
+public:
+    using CounterProvider = std::function<void(std::vector<MetricSample>&)>;
+
+private:
+    struct HistogramEntry {
+        std::string name;
+        std::string labels;
+        std::string help;
+        std::unique_ptr<LatencyHistogram> histogram;
+    };
+
+    struct ProviderEntry {
+        int id;
+        CounterProvider provider;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<HistogramEntry> histograms;
+    std::vector<ProviderEntry> providers;
+    int nextProviderId = 1;
+
+public:
+    // Get or create the histogram with this name and labels (name in seconds, values recorded in ns)
+    LatencyHistogram* histogram(const std::string& name, const std::string& labels = "", const std::string& help = "");
+
+    // Register a function that reports counters/gauges on every scrape. Returns an id for removeCounters().
+    int addCounters(CounterProvider provider);
+    // Unregister a provider; after this returns it is not called anymore
+    void removeCounters(int id);
+
+    // Prometheus text exposition format (histograms as summaries with p50/p99/p999)
+    std::string prometheusText() const;
+    // Human readable report with p50/p99/p999 in milliseconds
+    std::string reportText() const;
+};
+
+#endif // METRICSREGISTRY_H
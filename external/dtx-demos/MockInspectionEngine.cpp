@@ -0,0 +1,52 @@
+#include "MockInspectionEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+MockInspectionEngine::MockInspectionEngine(const MockEngineConfig& config)
+    : config(config), random(std::random_device()()) {
+}
+
+bool MockInspectionEngine::runOnFrame(const ImageView& image, InspectionResult& result) {
+    bool converted = false;
+    ImageView input = prepareEngineInput(image, config.caps, conversionBuffer, converted);
+    if (converted) {
+        ++conversionFallbacks;
+    }
+    if (input.format == FramePixelFormat::Unknown) {
+        std::cerr << "Mock engine cannot read this image format." << std::endl;
+        result.valid = false;
+        return false;
+    }
+    lastInput = input;
+
+    // Mean of the first channel on a sparse grid is enough for a verdict
+    const int bpp = bytesPerPixel(input.format);
+    uint64_t sum = 0;
+    uint64_t samples = 0;
+    for (int y = 0; y < input.height; y += 4) {
+        const uint8_t* row = input.data + y * input.stride;
+        for (int x = 0; x < input.width; x += 4) {
+            sum += row[x * bpp];
+            ++samples;
+        }
+    }
+
+    if (config.latencyMs > 0.0 || config.jitterMs > 0.0) {
+        std::uniform_real_distribution<double> jitter(-config.jitterMs, config.jitterMs);
+        const double delayMs = std::max(0.0, config.latencyMs + jitter(random));
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(delayMs));
+    }
+
+    result.value = samples > 0 ? static_cast<float>(static_cast<double>(sum) / samples) : 0.0f;
+    result.ok = result.value >= config.okThreshold;
+    result.valid = true;
+
+    const float mean = result.value;
+    const int verdict = result.ok ? 1 : 0;
+    result.outputs.clear();
+    result.outputs.add(ResultValues::Float, &mean, 1);
+    result.outputs.add(ResultValues::Int, &verdict, 1);
+    return true;
+}
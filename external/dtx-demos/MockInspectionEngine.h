@@ -0,0 +1,41 @@
+#ifndef MOCKINSPECTIONENGINE_H
+#define MOCKINSPECTIONENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "IInspectionEngine.h"
+#include "ImageConversion.h"
+
+struct MockEngineConfig {
+    EngineInputCaps caps;      // Layouts the mock pretends to accept without conversion
+    double okThreshold = 64.0; // Mean intensity at or above which a frame is OK
+    double latencyMs = 0.0;    // Simulated processing time per frame
+    double jitterMs = 0.0;     // Uniform spread around latencyMs
+};
+
+// SDK-free inspection backend: judges a frame by its mean intensity and takes
+// a configurable time to do so. Goes through the same input preparation as the
+// real backend, so zero-copy hand-over and conversion fallbacks can be checked
+// without VisionMaster.
+class MockInspectionEngine : public IInspectionEngine {
+private:
+    MockEngineConfig config;
+    std::vector<uint8_t> conversionBuffer;
+    std::atomic<uint64_t> conversionFallbacks{ 0 };
+    ImageView lastInput;
+    std::mt19937 random;
+
+public:
+    explicit MockInspectionEngine(const MockEngineConfig& config = MockEngineConfig());
+
+    bool runOnFrame(const ImageView& image, InspectionResult& result) override;
+    uint64_t conversionFallbackCount() const override { return conversionFallbacks.load(); }
+
+    // Image as it was handed to the backend by the last run
+    const ImageView& lastBackendInput() const { return lastInput; }
+};
+
+#endif // MOCKINSPECTIONENGINE_H
@@ -0,0 +1,178 @@
+#include "ResultLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+ResultLogHeader ResultLog::currentHeader() {
+    ResultLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "DTXRLOG", 8);
+    header.version = 1;
+    header.headerSize = sizeof(ResultLogHeader);
+    header.recordSize = sizeof(ResultLogRecord);
+    header.maxParams = ResultValues::MaxParams;
+    header.maxValues = ResultValues::MaxValues;
+    return header;
+}
+
+ResultLog::ResultLog(const ResultLogConfig& config)
+    : config(config), queue(std::max<size_t>(config.queueCapacity, 2)) {
+}
+
+ResultLog::~ResultLog() {
+    close();
+}
+
+bool ResultLog::open(const std::string& logPath) {
+    close();
+
+    const ResultLogHeader expected = currentHeader();
+    size_t existingSize = 0;
+    {
+        std::ifstream existing(logPath, std::ios::binary | std::ios::ate);
+        if (existing) {
+            existingSize = static_cast<size_t>(existing.tellg());
+        }
+        if (existingSize > 0) {
+            ResultLogHeader header;
+            existing.seekg(0);
+            if (!existing.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+                header.version != expected.version || header.recordSize != expected.recordSize ||
+                header.headerSize != expected.headerSize) {
+                std::cerr << "Result log " << logPath << " has a different format, not appending to it." << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // A crash while writing leaves a partial record; cut it off so new records stay aligned
+    const size_t completeSize = existingSize == 0 ? 0 : sizeof(ResultLogHeader) +
+        (existingSize - sizeof(ResultLogHeader)) / sizeof(ResultLogRecord) * sizeof(ResultLogRecord);
+    if (completeSize != existingSize) {
+        std::error_code error;
+        std::filesystem::resize_file(logPath, completeSize, error);
+        if (error) {
+            std::cerr << "Cannot truncate the partial record of result log " << logPath << ": " << error.message() << std::endl;
+            return false;
+        }
+        std::cerr << "Result log " << logPath << " ended with a partial record, truncated it." << std::endl;
+    }
+
+    file.open(logPath, std::ios::binary | std::ios::app);
+    if (!file) {
+        std::cerr << "Cannot open result log " << logPath << std::endl;
+        return false;
+    }
+    if (existingSize == 0) {
+        file.write(reinterpret_cast<const char*>(&expected), sizeof(expected));
+    }
+    file.flush();
+
+    path = logPath;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        head = tail = count = 0;
+        running = true;
+    }
+    writerThread = std::thread(&ResultLog::writerLoop, this);
+    return true;
+}
+
+void ResultLog::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wake.notify_all();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    file.close();
+}
+
+void ResultLog::append(const InspectedFrame& inspected) {
+    const InspectionResult& result = inspected.result;
+    const uint64_t wallTimeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running) {
+        return;
+    }
+    if (count == queue.size()) {
+        ++dropped;
+        return;
+    }
+
+    ResultLogRecord& record = queue[head];
+    std::memset(&record, 0, sizeof(record));
+    record.sequence = result.sequence;
+    record.frameNumber = result.frameNumber;
+    if (inspected.frame) {
+        record.deviceTimestampNs = inspected.frame->deviceTimestampNs;
+        record.hostTimestampNs = inspected.frame->hostTimestampNs;
+    }
+    record.inspectStartNs = result.inspectStartNs;
+    record.inspectEndNs = result.inspectEndNs;
+    record.publishNs = result.publishNs;
+    record.wallTimeNs = wallTimeNs;
+    record.value = result.value;
+    record.valid = result.valid ? 1 : 0;
+    record.ok = result.ok ? 1 : 0;
+    record.truncated = result.outputs.truncated ? 1 : 0;
+    record.paramCount = static_cast<uint8_t>(result.outputs.paramCount);
+    record.valueCount = static_cast<uint8_t>(result.outputs.valueCount);
+    std::memcpy(record.paramTypes, result.outputs.paramTypes, sizeof(record.paramTypes));
+    std::memcpy(record.paramSizes, result.outputs.paramSizes, sizeof(record.paramSizes));
+    std::memcpy(record.values, result.outputs.values, sizeof(double) * result.outputs.valueCount);
+
+    head = (head + 1) % queue.size();
+    ++count;
+    ++appended;
+    // The writer wakes up on its interval; only hurry it when the queue is half full
+    if (count == queue.size() / 2) {
+        wake.notify_one();
+    }
+}
+
+void ResultLog::writerLoop() {
+    const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(config.flushIntervalMs));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait_for(lock, interval, [this] { return !running || count >= queue.size() / 2; });
+        const bool stopping = !running;
+
+        // Write the queued records outside the lock; producers only touch free slots
+        while (count > 0) {
+            const size_t first = tail;
+            const size_t batch = std::min(count, queue.size() - tail);
+            lock.unlock();
+            file.write(reinterpret_cast<const char*>(&queue[first]), batch * sizeof(ResultLogRecord));
+            lock.lock();
+            tail = (tail + batch) % queue.size();
+            count -= batch;
+            if (file) {
+                written += batch;
+            }
+            else {
+                writeErrors += batch;
+                file.clear();
+            }
+        }
+        lock.unlock();
+        file.flush();
+        lock.lock();
+
+        if (stopping) {
+            return;
+        }
+    }
+}
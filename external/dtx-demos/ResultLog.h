@@ -0,0 +1,115 @@
+#ifndef RESULTLOG_H
+#define RESULTLOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "InspectionResult.h"
+
+// On-disk layout of a result log: one ResultLogHeader, then fixed-size ResultLogRecords
+// back to back, in host byte order (little endian on every line PC). A reader can mmap
+// the file and index the records as an array: records = (fileSize - headerSize) / recordSize.
+// A trailing partial record (crash while writing) is ignored by readers and cut off by
+// ResultLog::open before it appends.
+struct ResultLogHeader {
+    char magic[8];          // "DTXRLOG" + '\0'
+    uint32_t version;       // 1
+    uint32_t headerSize;    // sizeof(ResultLogHeader)
+    uint32_t recordSize;    // sizeof(ResultLogRecord)
+    uint32_t maxParams;     // ResultValues::MaxParams
+    uint32_t maxValues;     // ResultValues::MaxValues
+    uint8_t reserved[36];
+};
+
+struct ResultLogRecord {
+    uint64_t sequence;
+    uint64_t frameNumber;
+    uint64_t deviceTimestampNs;
+    uint64_t hostTimestampNs;   // Sink pop, steady clock (like all stage times)
+    uint64_t inspectStartNs;
+    uint64_t inspectEndNs;
+    uint64_t publishNs;
+    uint64_t wallTimeNs;        // System clock when logged, nanoseconds since 1970
+    float value;
+    uint8_t valid;
+    uint8_t ok;
+    uint8_t truncated;
+    uint8_t paramCount;
+    uint8_t valueCount;
+    uint8_t reserved[7];
+    uint8_t paramTypes[ResultValues::MaxParams]; // ResultValues::ParamType, 0 = no values
+    uint8_t paramSizes[ResultValues::MaxParams];
+    double values[ResultValues::MaxValues];
+};
+
+static_assert(sizeof(ResultLogHeader) == 64, "ResultLogHeader layout changed");
+static_assert(sizeof(ResultLogRecord) == 352, "ResultLogRecord layout changed, bump the version");
+static_assert(std::is_trivially_copyable<ResultLogRecord>::value, "ResultLogRecord is written as raw bytes");
+
+struct ResultLogConfig {
+    size_t queueCapacity = 4096;   // Records buffered in memory; beyond that new records are dropped
+    double flushIntervalMs = 200.0; // Longest time a record waits before it is written
+};
+
+// Append-only binary log of every inspection result. append() only copies the result into
+// a preallocated queue, so it never waits for the disk; a writer thread appends the
+// records to the file in batches. If the disk falls behind and the queue is full, records
+// are dropped and counted, the inspection is never held up.
+class ResultLog {
+private:
+    ResultLogConfig config;
+    std::string path;
+    std::ofstream file;
+
+    // Ring of records; producers fill free slots, the writer drains [tail, tail + count)
+    std::vector<ResultLogRecord> queue;
+    size_t head = 0;
+    size_t tail = 0;
+    size_t count = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread writerThread;
+    bool running = false;
+
+    std::atomic<uint64_t> appended{ 0 };
+    std::atomic<uint64_t> written{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> writeErrors{ 0 };
+
+    void writerLoop();
+
+public:
+    explicit ResultLog(const ResultLogConfig& config = ResultLogConfig());
+    ~ResultLog();
+
+    ResultLog(const ResultLog&) = delete;
+    ResultLog& operator=(const ResultLog&) = delete;
+
+    // Open 'path' for appending (created with a header if new) and start the writer.
+    // Fails if the file exists with a different record layout.
+    bool open(const std::string& path);
+    // Write everything still queued and close the file
+    void close();
+
+    // Queue one result (any thread, never blocks on I/O)
+    void append(const InspectedFrame& inspected);
+
+    uint64_t appendedCount() const { return appended.load(); }
+    uint64_t writtenCount() const { return written.load(); }
+    // Records lost because the queue was full
+    uint64_t droppedCount() const { return dropped.load(); }
+    uint64_t writeErrorCount() const { return writeErrors.load(); }
+
+    // Header values of this build, for files created by it
+    static ResultLogHeader currentHeader();
+};
+
+#endif // RESULTLOG_H
@@ -0,0 +1,475 @@
+#include "SyntheticCameraSource.h"
+#include "ImageConversion.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef DTX_HAVE_OPENCV
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+#endif
+
+namespace fs = std::filesystem;
+
+#ifdef DTX_HAVE_OPENCV
+struct SyntheticCameraSource::VideoReader {
+    cv::VideoCapture capture;
+    cv::Mat frame;
+    std::vector<uint8_t> scratch;
+};
+#else
+struct SyntheticCameraSource::VideoReader {
+};
+#endif
+
+static std::string lowerExtension(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+static bool isImageExtension(const std::string& ext) {
+    return ext == ".pgm" || ext == ".ppm" || ext == ".png" || ext == ".jpg" || ext == ".jpeg" ||
+        ext == ".bmp" || ext == ".tif" || ext == ".tiff";
+}
+
+// Convert 'image' into the configured format with tight rows
+static bool convertTo(const ImageView& image, FramePixelFormat format, std::vector<uint8_t>& pixels) {
+    EngineInputCaps caps;
+    caps.mono8 = format == FramePixelFormat::Mono8;
+    caps.bgr8 = format == FramePixelFormat::BGR8;
+    caps.rgb8 = format == FramePixelFormat::RGB8;
+    caps.paddedRows = false;
+
+    bool converted = false;
+    std::vector<uint8_t> scratch;
+    ImageView out = prepareEngineInput(image, caps, scratch, converted);
+    if (out.format != format) {
+        return false;
+    }
+    pixels.assign(out.data, out.data + out.stride * out.height);
+    return true;
+}
+
+// Read a binary PGM (P5) or PPM (P6) file with 8 bit samples
+static bool readPnm(const std::string& path, std::vector<uint8_t>& pixels, ImageView& view) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::string magic;
+    file >> magic;
+    int values[3] = { 0, 0, 0 };
+    for (int& value : values) {
+        file >> std::ws;
+        while (file.peek() == '#') {
+            std::string comment;
+            std::getline(file, comment);
+            file >> std::ws;
+        }
+        file >> value;
+    }
+    file.get(); // Single whitespace before the pixel data
+
+    const int width = values[0];
+    const int height = values[1];
+    const int maxValue = values[2];
+    if ((magic != "P5" && magic != "P6") || width <= 0 || height <= 0 || maxValue != 255) {
+        return false;
+    }
+
+    const bool color = magic == "P6";
+    const size_t stride = static_cast<size_t>(width) * (color ? 3 : 1);
+    pixels.resize(stride * height);
+    if (!file.read(reinterpret_cast<char*>(pixels.data()), pixels.size())) {
+        return false;
+    }
+
+    view.data = pixels.data();
+    view.width = width;
+    view.height = height;
+    view.stride = stride;
+    view.format = color ? FramePixelFormat::RGB8 : FramePixelFormat::Mono8;
+    return true;
+}
+
+SyntheticCameraSource::SyntheticCameraSource(const SyntheticSourceConfig& config)
+    : config(config) {
+}
+
+SyntheticCameraSource::~SyntheticCameraSource() {
+    stopStream();
+}
+
+bool SyntheticCameraSource::loadImageFile(const std::string& path, std::vector<uint8_t>& pixels) {
+    std::vector<uint8_t> decoded;
+    ImageView view;
+
+    const std::string ext = lowerExtension(path);
+    if (ext == ".pgm" || ext == ".ppm") {
+        if (!readPnm(path, decoded, view)) {
+            std::cerr << "Failed to read image '" << path << "'." << std::endl;
+            return false;
+        }
+    }
+    else {
+#ifdef DTX_HAVE_OPENCV
+        cv::Mat mat = cv::imread(path, cv::IMREAD_UNCHANGED);
+        if (mat.empty() || mat.depth() != CV_8U) {
+            std::cerr << "Failed to read image '" << path << "'." << std::endl;
+            return false;
+        }
+        decoded.assign(mat.data, mat.data + mat.step * mat.rows);
+        view.data = decoded.data();
+        view.width = mat.cols;
+        view.height = mat.rows;
+        view.stride = mat.step;
+        view.format = mat.channels() == 1 ? FramePixelFormat::Mono8 :
+            mat.channels() == 4 ? FramePixelFormat::BGRa8 : FramePixelFormat::BGR8;
+#else
+        std::cerr << "Reading '" << path << "' needs OpenCV, only .pgm/.ppm are supported." << std::endl;
+        return false;
+#endif
+    }
+
+    // The first image sets the frame size
+    if (replayFrames.empty()) {
+        config.width = view.width;
+        config.height = view.height;
+    }
+    else if (view.width != config.width || view.height != config.height) {
+        std::cerr << "Skipping '" << path << "': size differs from the first frame." << std::endl;
+        return false;
+    }
+
+    return convertTo(view, config.format, pixels);
+}
+
+bool SyntheticCameraSource::loadReplay() {
+    replayFrames.clear();
+    video.reset();
+
+    const fs::path path(config.replayPath);
+    std::error_code ec;
+
+    if (fs::is_directory(path, ec)) {
+        std::vector<fs::path> files;
+        for (const auto& entry : fs::directory_iterator(path, ec)) {
+            if (entry.is_regular_file() && isImageExtension(lowerExtension(entry.path()))) {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files) {
+            std::vector<uint8_t> pixels;
+            if (loadImageFile(file.string(), pixels)) {
+                replayFrames.push_back(std::move(pixels));
+            }
+        }
+    }
+    else if (isImageExtension(lowerExtension(path))) {
+        std::vector<uint8_t> pixels;
+        if (loadImageFile(path.string(), pixels)) {
+            replayFrames.push_back(std::move(pixels));
+        }
+    }
+    else {
+#ifdef DTX_HAVE_OPENCV
+        video.reset(new VideoReader());
+        if (!video->capture.open(path.string()) ||
+            !video->capture.read(video->frame) || video->frame.empty()) {
+            std::cerr << "Failed to open video '" << path.string() << "'." << std::endl;
+            video.reset();
+            return false;
+        }
+        config.width = video->frame.cols;
+        config.height = video->frame.rows;
+        video->capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+        return true;
+#else
+        std::cerr << "Replaying video '" << path.string() << "' needs OpenCV." << std::endl;
+        return false;
+#endif
+    }
+
+    if (replayFrames.empty()) {
+        std::cerr << "No frames to replay in '" << config.replayPath << "'." << std::endl;
+        return false;
+    }
+    std::cout << "Loaded " << replayFrames.size() << " frame(s) for replay ("
+        << config.width << "x" << config.height << ")." << std::endl;
+    return true;
+}
+
+bool SyntheticCameraSource::produceFrame(uint8_t* buffer) {
+    const int bpp = bytesPerPixel(config.format);
+    const size_t stride = static_cast<size_t>(config.width) * bpp;
+    const size_t frameSize = stride * config.height;
+
+    if (!replayFrames.empty()) {
+        const uint64_t index = frameCounter % replayFrames.size();
+        if (!config.loop && frameCounter >= replayFrames.size()) {
+            return false;
+        }
+        std::memcpy(buffer, replayFrames[index].data(), frameSize);
+        return true;
+    }
+
+#ifdef DTX_HAVE_OPENCV
+    if (video) {
+        if (!video->capture.read(video->frame) || video->frame.empty()) {
+            if (!config.loop) {
+                return false;
+            }
+            video->capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+            if (!video->capture.read(video->frame) || video->frame.empty()) {
+                return false;
+            }
+        }
+        ImageView view;
+        view.data = video->frame.data;
+        view.width = video->frame.cols;
+        view.height = video->frame.rows;
+        view.stride = video->frame.step;
+        view.format = video->frame.channels() == 1 ? FramePixelFormat::Mono8 : FramePixelFormat::BGR8;
+        if (view.width != config.width || view.height != config.height ||
+            !convertTo(view, config.format, video->scratch)) {
+            return false;
+        }
+        std::memcpy(buffer, video->scratch.data(), frameSize);
+        return true;
+    }
+#endif
+
+    // Moving diagonal gradient; brightness follows the exposure, every n-th frame is dark
+    const bool dark = config.nokEvery > 0 && (frameCounter % config.nokEvery) == static_cast<uint64_t>(config.nokEvery - 1);
+    const double gain = std::min(2.0, exposureUs.load() / 5000.0) * (dark ? 0.25 : 1.0);
+
+    std::vector<uint8_t>& pattern = patternRow;
+    pattern.resize((static_cast<size_t>(config.width) + 256) * bpp);
+    for (int x = 0; x < config.width + 256; ++x) {
+        const uint8_t value = static_cast<uint8_t>(std::min(255.0, (x & 0xFF) * gain));
+        for (int c = 0; c < bpp; ++c) {
+            pattern[x * bpp + c] = value;
+        }
+    }
+    for (int y = 0; y < config.height; ++y) {
+        const size_t offset = static_cast<size_t>((frameCounter * 4 + y) & 0xFF) * bpp;
+        std::memcpy(buffer + y * stride, pattern.data() + offset, stride);
+    }
+    return true;
+}
+
+void SyntheticCameraSource::acquisitionLoop() {
+    using clock = std::chrono::steady_clock;
+    const auto period = config.fps > 0.0 ?
+        std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / config.fps)) :
+        clock::duration::zero();
+    auto nextFrame = clock::now();
+
+    while (running) {
+        bool triggered = false;
+        {
+            std::lock_guard<std::mutex> lock(triggerMutex);
+            triggered = !triggerSource.empty();
+        }
+        if (triggered) {
+            if (!waitForTrigger()) {
+                continue;
+            }
+        }
+        else if (period > clock::duration::zero()) {
+            std::this_thread::sleep_until(nextFrame);
+            nextFrame += period;
+            // A camera does not catch up on frames it could not expose
+            if (clock::now() > nextFrame + period) {
+                nextFrame = clock::now() + period;
+            }
+        }
+
+        std::shared_ptr<uint8_t> buffer = pool->acquire();
+        if (!buffer) {
+            ++underruns;
+            ++frameCounter;
+            if (period == clock::duration::zero()) {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        if (!produceFrame(buffer.get())) {
+            break;
+        }
+
+        Frame frame;
+        frame.frameNumber = frameCounter++;
+        frame.deviceTimestampNs = steadyNowNs();
+        frame.hostTimestampNs = frame.deviceTimestampNs;
+        frame.image.data = buffer.get();
+        frame.image.width = config.width;
+        frame.image.height = config.height;
+        frame.image.stride = static_cast<size_t>(config.width) * bytesPerPixel(config.format);
+        frame.image.format = config.format;
+        frame.owner = std::move(buffer);
+
+        frameCallback(tracker.track(std::move(frame)));
+        ++delivered;
+    }
+    running = false;
+}
+
+bool SyntheticCameraSource::startStream(FrameCallback callback) {
+    if (running) {
+        std::cout << "Already grabbing." << std::endl;
+        return true;
+    }
+    if (acquisitionThread.joinable()) {
+        acquisitionThread.join(); // A finished non-looping replay
+    }
+    if (bytesPerPixel(config.format) == 0 || config.format == FramePixelFormat::BGRa8) {
+        std::cerr << "Synthetic source supports Mono8, BGR8 and RGB8 only." << std::endl;
+        return false;
+    }
+    if (!config.replayPath.empty() && !loadReplay()) {
+        return false;
+    }
+    if (config.width <= 0 || config.height <= 0) {
+        std::cerr << "Invalid synthetic frame size." << std::endl;
+        return false;
+    }
+
+    const size_t frameSize = static_cast<size_t>(config.width) * config.height * bytesPerPixel(config.format);
+    pool.reset(new BufferPool(std::max<size_t>(config.bufferCount, 1), frameSize, config.numaNode));
+    frameCallback = std::move(callback);
+    frameCounter = 0;
+    running = true;
+    acquisitionThread = std::thread(&SyntheticCameraSource::acquisitionLoop, this);
+    return true;
+}
+
+bool SyntheticCameraSource::stopStream() {
+    {
+        std::lock_guard<std::mutex> lock(triggerMutex);
+        running = false;
+    }
+    triggerWake.notify_all();
+    if (acquisitionThread.joinable()) {
+        acquisitionThread.join();
+    }
+    return true;
+}
+
+bool SyntheticCameraSource::setExposure(double exposure) {
+    if (exposure <= 0.0) {
+        std::cerr << "Invalid exposure: " << exposure << std::endl;
+        return false;
+    }
+    exposureUs = exposure;
+    return true;
+}
+
+std::string SyntheticCameraSource::description() const {
+    std::string text = "Synthetic " + std::to_string(config.width) + "x" + std::to_string(config.height);
+    if (!config.replayPath.empty()) {
+        text += " replay of " + config.replayPath;
+    }
+    return text;
+}
+
+SourceStatistics SyntheticCameraSource::statistics() {
+    SourceStatistics stats;
+    stats.delivered = delivered.load();
+    stats.sinkUnderruns = underruns.load();
+    stats.missedTriggers = missedTriggers.load();
+    return stats;
+}
+
+bool SyntheticCameraSource::configureTrigger(const std::string& source, double delay) {
+    if (source != "Software" && source != "Line1") {
+        std::cerr << "Synthetic source supports Software and Line1 triggers only." << std::endl;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(triggerMutex);
+        triggerSource = source;
+        triggerDelayUs = delay > 0.0 ? delay : 0.0;
+        pendingTriggers = 0;
+    }
+    triggerWake.notify_all();
+    return true;
+}
+
+bool SyntheticCameraSource::disableTriggerMode() {
+    {
+        std::lock_guard<std::mutex> lock(triggerMutex);
+        triggerSource.clear();
+        pendingTriggers = 0;
+    }
+    triggerWake.notify_all();
+    return true;
+}
+
+bool SyntheticCameraSource::sendSoftwareTrigger() {
+    {
+        std::lock_guard<std::mutex> lock(triggerMutex);
+        if (triggerSource != "Software") {
+            std::cerr << "Trigger mode not enabled." << std::endl;
+            return false;
+        }
+        ++pendingTriggers;
+    }
+    triggerWake.notify_all();
+    return true;
+}
+
+void SyntheticCameraSource::setTriggerObserver(std::function<void(uint64_t)> observer) {
+    std::lock_guard<std::mutex> lock(triggerMutex);
+    triggerObserver = std::move(observer);
+}
+
+bool SyntheticCameraSource::waitForTrigger() {
+    using clock = std::chrono::steady_clock;
+    std::function<void(uint64_t)> observer;
+    uint64_t triggerIndex = 0;
+    double delayUs = 0.0;
+    {
+        std::unique_lock<std::mutex> lock(triggerMutex);
+        const std::string source = triggerSource;
+        if (source == "Line1") {
+            // The simulated line pulses at a fixed rate while the camera is armed
+            const auto period = std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(1.0 / (config.linePulseHz > 0.0 ? config.linePulseHz : 1.0)));
+            triggerWake.wait_for(lock, period, [&] { return !running || triggerSource != source; });
+            if (!running || triggerSource != source) {
+                return false;
+            }
+            observer = triggerObserver;
+        }
+        else {
+            triggerWake.wait(lock, [&] { return !running || pendingTriggers > 0 || triggerSource != source; });
+            if (!running || pendingTriggers == 0 || triggerSource != source) {
+                return false;
+            }
+            --pendingTriggers;
+        }
+        triggerIndex = ++triggersReceived;
+        delayUs = triggerDelayUs;
+    }
+
+    if (observer) {
+        observer(steadyNowNs());
+    }
+    if (config.missTriggerEvery > 0 && triggerIndex % config.missTriggerEvery == 0) {
+        ++missedTriggers;
+        return false;
+    }
+    // Trigger delay, exposure and readout before the frame arrives
+    std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(delayUs + exposureUs.load()));
+    return running;
+}
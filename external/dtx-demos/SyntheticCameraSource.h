@@ -0,0 +1,105 @@
+#ifndef SYNTHETICCAMERASOURCE_H
+#define SYNTHETICCAMERASOURCE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BufferPool.h"
+#include "ICameraSource.h"
+
+struct SyntheticSourceConfig {
+    int width = 640;
+    int height = 480;
+    FramePixelFormat format = FramePixelFormat::RGB8; // Like the camera sink
+    double fps = 30.0;       // 0 = as fast as possible
+    size_t bufferCount = 8;  // Like the sink buffer count: frames consumers may hold at once
+    int nokEvery = 10;       // Every n-th generated frame is dark (NOK for the mock engine), 0 = never
+    // Directory of images (.pgm/.ppm, plus .png/.jpg/.bmp with OpenCV) or a video file
+    // (with OpenCV) to replay instead of the generated pattern. Size follows the recording.
+    std::string replayPath;
+    bool loop = true;        // Restart the recording at its end
+    int numaNode = -1;       // Place the buffer pool on this NUMA node, -1 = default placement
+    // Trigger mode: each trigger yields one frame after the exposure time (plus trigger delay)
+    double linePulseHz = 10.0; // Rate of the simulated Line1 pulses while armed for "Line1"
+    int missTriggerEvery = 0;  // Every n-th trigger produces no frame (camera still busy), 0 = never
+};
+
+// Camera simulator for headless benchmarking: generates a test pattern or replays
+// recorded frames at a fixed rate into a preallocated buffer pool. When consumers
+// hold every buffer, the frame is dropped and counted as an underrun, like a sink.
+class SyntheticCameraSource : public ICameraSource {
+private:
+    SyntheticSourceConfig config;
+    std::unique_ptr<BufferPool> pool;
+    FrameTracker tracker;
+    FrameCallback frameCallback;
+    std::thread acquisitionThread;
+    std::atomic<bool> running{ false };
+    std::atomic<double> exposureUs{ 5000.0 };
+
+    // Preloaded replay frames, already in the configured format with tight rows
+    std::vector<std::vector<uint8_t>> replayFrames;
+    struct VideoReader;
+    std::unique_ptr<VideoReader> video;
+    std::vector<uint8_t> patternRow; // Reused by the generated pattern
+
+    uint64_t frameCounter = 0;
+    std::atomic<uint64_t> delivered{ 0 };
+    std::atomic<uint64_t> underruns{ 0 };
+    std::atomic<uint64_t> missedTriggers{ 0 };
+
+    // Trigger state; empty triggerSource = free run
+    std::mutex triggerMutex;
+    std::condition_variable triggerWake;
+    std::string triggerSource;
+    double triggerDelayUs = 0.0;
+    uint64_t pendingTriggers = 0;
+    uint64_t triggersReceived = 0;
+    std::function<void(uint64_t)> triggerObserver;
+
+    // Block until the next trigger. Returns false if stopped, switched to free run or the trigger is missed.
+    bool waitForTrigger();
+
+    bool loadReplay();
+    bool loadImageFile(const std::string& path, std::vector<uint8_t>& pixels);
+    // Fill 'buffer' with the next frame. Returns false at the end of a non-looping recording.
+    bool produceFrame(uint8_t* buffer);
+    void acquisitionLoop();
+
+public:
+    explicit SyntheticCameraSource(const SyntheticSourceConfig& config = SyntheticSourceConfig());
+    ~SyntheticCameraSource() override;
+
+    bool startStream(FrameCallback callback) override;
+    bool stopStream() override;
+    bool streaming() const override { return running.load(); }
+
+    bool setExposure(double exposure) override;
+    double getExposure() override { return exposureUs.load(); }
+
+    std::string description() const override;
+
+    size_t buffersInFlight() const override { return tracker.buffersInFlight(); }
+    size_t peakBuffersInFlight() const override { return tracker.peakBuffersInFlight(); }
+    SourceStatistics statistics() override;
+
+    bool configureTrigger(const std::string& source = "Software", double delay = 0.0) override;
+    bool disableTriggerMode() override;
+    bool sendSoftwareTrigger() override;
+    // Called with steadyNowNs() of every simulated Line1 pulse, like an I/O card watching the line
+    void setTriggerObserver(std::function<void(uint64_t)> observer);
+
+    // Frames handed to the callback
+    uint64_t deliveredCount() const { return delivered.load(); }
+    // Frames dropped because every buffer was still held by a consumer
+    uint64_t underrunCount() const { return underruns.load(); }
+};
+
+#endif // SYNTHETICCAMERASOURCE_H
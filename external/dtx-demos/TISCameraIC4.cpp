@@ -1,4 +1,6 @@
 ﻿#include "TISCameraIC4.h"
+#include "VisionMasterProcessor.h"
+#include "Log.h"
 #include <iostream>
 #include <string>
 #include <iomanip>
@@ -10,6 +12,7 @@ currentExposure(5000), sliderValue(50) {
 
 TISCameraIC4::~TISCameraIC4() {
     disconnect();
+    detachMetrics();
 }
 
 
@@ -47,8 +50,20 @@ void TISCameraIC4::updateSliderFromExposure() {
     }
 }
 
+// Redraws the panel only when a shown value changed; the panel image is allocated once
 void TISCameraIC4::updateParameterDisplay() {
-    cv::Mat controlPanel = cv::Mat::zeros(250, 800, CV_8UC3);
+    if (!controlPanel.empty() && panelExposure == currentExposure &&
+        panelTriggerMode == triggerModeEnabled && panelTriggerSource == currentTriggerSource) {
+        return;
+    }
+    panelExposure = currentExposure;
+    panelTriggerMode = triggerModeEnabled;
+    panelTriggerSource = currentTriggerSource;
+
+    if (controlPanel.empty()) {
+        controlPanel.create(250, 800, CV_8UC3);
+    }
+    controlPanel.setTo(cv::Scalar::all(0));
 
     std::string exposureText = "Current Exposure: " +
         std::to_string(currentExposure / 1000.0).substr(0, 6) + " ms";
@@ -69,7 +84,7 @@ void TISCameraIC4::updateParameterDisplay() {
         cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(200, 200, 255), 1);
 
     // Updated control instructions
-    std::string instructions = "Controls: ESC=Exit, t=Toggle Trigger, s=Software Trigger";
+    std::string instructions = "Controls: ESC=Exit, t=Toggle Trigger, s=Software Trigger, a=Archive";
     cv::putText(controlPanel, instructions, cv::Point(20, 150),
         cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(200, 200, 200), 1);
 
@@ -86,21 +101,26 @@ void TISCameraIC4::updateParameterDisplay() {
 
 // Also update the onExposureChange to refresh the display
 void TISCameraIC4::onExposureChange(int value, void* userdata) {
+    // Dragging the slider fires a burst of events; only the latest position is applied,
+    // once per display iteration (applyPendingExposure)
     TISCameraIC4* camera = static_cast<TISCameraIC4*>(userdata);
+    camera->pendingSliderValue.store(value, std::memory_order_relaxed);
+}
 
-    // Convert slider value (0–100000) to exposure range
-    double exposureRange = camera->maxExposure - camera->minExposure;
-    double newExposure = camera->minExposure +
-        (exposureRange * value / 10000000.0);  // Fixed: removed extra zero
-
-    camera->currentExposure = newExposure;
-    camera->setExposure(newExposure);
+// Apply the last slider position, if it moved since the last call
+void TISCameraIC4::applyPendingExposure() {
+    const int value = pendingSliderValue.exchange(-1, std::memory_order_relaxed);
+    if (value < 0) {
+        return;
+    }
 
-    // Update the display with the new exposure value
-    camera->updateParameterDisplay();
+    // Convert slider value (0–100000) to exposure range, the inverse of updateSliderFromExposure
+    double exposureRange = maxExposure - minExposure;
+    double newExposure = minExposure + (exposureRange * value / 100000.0);
 
-    std::cout << "Exposure set to: " << newExposure << " μs ("
-        << (newExposure / 1000.0) << " ms)" << std::endl;
+    if (setExposure(newExposure)) {
+        DTX_LOG(Info, "Exposure set to: " << newExposure << " us (" << (newExposure / 1000.0) << " ms)");
+    }
 }
 
 // List available cameras using IC4
@@ -138,43 +158,69 @@ bool TISCameraIC4::connect(int cameraIndex) {
             return false;
         }
 
-        ic4::Error err;
-        auto&& dev_info = device_list[cameraIndex];
+        return openDevice(device_list[cameraIndex]);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error connecting to camera: " << e.what() << std::endl;
+        return false;
+    }
+}
 
-        // Open the device
-        if (!grabber.deviceOpen(dev_info, err)) {
-            std::cerr << "Failed to open camera device." << std::endl;
-            return false;
+// Connect to camera by serial number
+bool TISCameraIC4::connectBySerial(const std::string& serial) {
+    try {
+        for (auto&& dev_info : ic4::DeviceEnum::enumDevices()) {
+            if (dev_info.serial() == serial) {
+                return openDevice(dev_info);
+            }
         }
+        std::cerr << "No camera with serial " << serial << " found." << std::endl;
+        return false;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error connecting to camera: " << e.what() << std::endl;
+        return false;
+    }
+}
 
-        auto map = grabber.devicePropertyMap(err);
-        if (err.isError()) {
-            std::cerr << "Failed to get device property map: " << err.message() << std::endl;
-            return false;
-        }
+bool TISCameraIC4::openDevice(const ic4::DeviceInfo& dev_info) {
+    ic4::Error err;
 
-        map.setValue(ic4::PropId::UserSetSelector, "Default", ic4::Error::Ignore());
-        map.executeCommand(ic4::PropId::UserSetLoad, ic4::Error::Ignore());
+    // Open the device
+    if (!grabber.deviceOpen(dev_info, err)) {
+        std::cerr << "Failed to open camera device." << std::endl;
+        return false;
+    }
 
-        isConnected = true;
-        std::cout << "Connected to camera: " << formatDeviceInfo(dev_info) << std::endl;
+    auto map = grabber.devicePropertyMap(err);
+    if (err.isError()) {
+        std::cerr << "Failed to get device property map: " << err.message() << std::endl;
+        return false;
+    }
 
-        // Display current exposure settings
-        displayExposureInfo();
-        toggleAutoExposureMode();
+    map.setValue(ic4::PropId::UserSetSelector, "Default", ic4::Error::Ignore());
+    map.executeCommand(ic4::PropId::UserSetLoad, ic4::Error::Ignore());
 
-        return true;
+    // Resolve the property handles once; every setter below uses them
+    properties.resolve(map);
+    minExposure = properties.exposureMin;
+    maxExposure = properties.exposureMax;
 
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error connecting to camera: " << e.what() << std::endl;
-        return false;
-    }
+    isConnected = true;
+    device = dev_info;
+    std::cout << "Connected to camera: " << formatDeviceInfo(dev_info) << std::endl;
+
+    // Display current exposure settings
+    displayExposureInfo();
+    toggleAutoExposureMode();
+
+    return true;
 }
 
 // Disconnect camera
 void TISCameraIC4::disconnect() {
     if (isConnected) {
+        properties.clear();
         grabber.deviceClose();
         isConnected = false;
         std::cout << "Camera disconnected." << std::endl;
@@ -187,16 +233,13 @@ bool TISCameraIC4::toggleAutoExposureMode() {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-        map.setValue(ic4::PropId::ExposureAuto, "Off");
-        displayExposureInfo();
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error setting exposure: " << e.what() << std::endl;
+    std::string error;
+    if (!properties.setEnumeration(properties.exposureAuto, "Off", error)) {
+        std::cerr << "Error setting exposure: " << error << std::endl;
         return false;
     }
+    displayExposureInfo();
+    return true;
 }
 
 // Set exposure time in microseconds
@@ -206,16 +249,13 @@ bool TISCameraIC4::setExposure(double exposureUs) {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-        map.setValue(ic4::PropId::ExposureTime, exposureUs);
-        currentExposure = exposureUs;
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error setting exposure: " << e.what() << std::endl;
+    std::string error;
+    if (!properties.setFloat(properties.exposureTime, exposureUs, error)) {
+        std::cerr << "Error setting exposure: " << error << std::endl;
         return false;
     }
+    currentExposure = exposureUs;
+    return true;
 }
 
 double TISCameraIC4::getExposure() {
@@ -224,16 +264,14 @@ double TISCameraIC4::getExposure() {
         return -1.0;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-        auto propExposureTime = map.find(ic4::PropId::ExposureTime);
-        if (propExposureTime.is_valid() && propExposureTime.isAvailable()) {
-            currentExposure = propExposureTime.getValue();
+    ic4::Error err;
+    if (properties.exposureTime.is_valid()) {
+        const double value = properties.exposureTime.getValue(err);
+        if (!err.isError()) {
+            currentExposure = value;
             return currentExposure;
         }
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error getting exposure: " << e.what() << std::endl;
+        std::cerr << "Error getting exposure: " << err.message() << std::endl;
     }
     return -1.0;
 }
@@ -245,21 +283,15 @@ bool TISCameraIC4::getExposureRange(double& min, double& max) {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-        auto propExposureTime = map.find(ic4::PropId::ExposureTime);
-        if (propExposureTime.is_valid() && propExposureTime.isAvailable()) {
-            min = propExposureTime.minimum();
-            max = propExposureTime.maximum();
-            minExposure = min;
-            maxExposure = max;
-            return true;
-        }
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error getting exposure range: " << e.what() << std::endl;
+    // Read once when the device was opened
+    if (!properties.exposureTime.is_valid()) {
+        return false;
     }
-    return false;
+    min = properties.exposureMin;
+    max = properties.exposureMax;
+    minExposure = min;
+    maxExposure = max;
+    return true;
 }
 
 // Display current exposure information
@@ -313,8 +345,8 @@ void TISCameraIC4::displayExposureInfo() {
     }
 }
 
-// Start grabbing frames with parameter control window
-bool TISCameraIC4::startGrabbing() {
+// Start streaming into a callback, without inspection or display
+bool TISCameraIC4::startStream(FrameCallback callback) {
     if (!isConnected) {
         std::cerr << "Camera not connected." << std::endl;
         return false;
@@ -326,19 +358,19 @@ bool TISCameraIC4::startGrabbing() {
     }
 
     try {
-        // Initialize the parameter control window
-        initParameterControlWindow();
-
-        grabber.devicePropertyMap().setValue(ic4::PropId::Width, width);
-        grabber.devicePropertyMap().setValue(ic4::PropId::Height, height);
+        std::string error;
+        if (!properties.setInteger(properties.width, width, error) ||
+            !properties.setInteger(properties.height, height, error)) {
+            std::cerr << "Failed to set resolution " << width << "x" << height << ": " << error << std::endl;
+        }
 
         ic4::Error err;
 
         // Create the frame listener
-        frameListener = std::make_shared<GrabbingImage>();
+        frameListener = std::make_shared<GrabbingImage>(sinkBufferCount, std::move(callback));
 
         // Create the queue sink with our listener
-        queueSink = ic4::QueueSink::create(*frameListener, ic4::PixelFormat::BGR8, err);
+        queueSink = ic4::QueueSink::create(*frameListener, sinkPixelFormat, err);
 
         if (!queueSink) {
             std::cerr << "Failed to create sink: " << err.message() << std::endl;
@@ -352,137 +384,242 @@ bool TISCameraIC4::startGrabbing() {
         }
 
         isGrabbing = true;
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error starting stream: " << e.what() << std::endl;
+        return false;
+    }
+}
 
-        std::cout << "Starting camera feed. Use the exposure slider in 'Parameter Control' window." << std::endl;
-        std::cout << "Press ESC to exit, 't' to trigger (if trigger mode enabled)..." << std::endl;
+// Stop streaming
+bool TISCameraIC4::stopStream() {
+    if (!isGrabbing) {
+        return true;
+    }
 
-        // Create display window
-        cv::namedWindow("Camera Feed", cv::WINDOW_NORMAL);
-        cv::resizeWindow("Camera Feed", width, height);
+    ic4::Error err;
+    isGrabbing = false;
+    if (!grabber.streamStop(err)) {
+        std::cerr << "Error stopping stream: " << err.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string TISCameraIC4::description() const {
+    if (!isConnected) {
+        return "Not connected";
+    }
+    return formatDeviceInfo(device);
+}
 
-        // Main display loop
-        while (isGrabbing) {
-            cv::Mat currentFrame;
+SourceStatistics TISCameraIC4::statistics() {
+    SourceStatistics stats;
+    if (!isConnected) {
+        return stats;
+    }
 
-            // Get the latest frame from the listener
-            if (frameListener->getLatestFrame(currentFrame)) {
-                std::string statusText;
-                cv::Scalar color;
+    ic4::Error err;
+    auto ic4Stats = grabber.streamStatistics(err);
+    if (err.isError()) {
+        return stats;
+    }
+    stats.delivered = ic4Stats.sink_delivered;
+    stats.deviceUnderruns = ic4Stats.device_underrun;
+    stats.transmissionErrors = ic4Stats.device_transmission_error;
+    stats.sinkUnderruns = ic4Stats.sink_underrun;
+    stats.sinkIgnored = ic4Stats.sink_ignored;
+    return stats;
+}
 
-				float result = frameListener->getResult();
-                if (result == 1.0f) {
-                    statusText = "OK";
-                    color = cv::Scalar(0, 255, 0); // Green color (BGR format)
-                }
-                else {
-                    statusText = "NOK";
-                    color = cv::Scalar(0, 0, 255); // Red color for NOK (BGR format)
-                }
+// Register the display histograms and the driver counters, labelled with the camera serial
+void TISCameraIC4::attachMetrics() {
+    detachMetrics();
+    if (metricsRegistry == nullptr) {
+        return;
+    }
 
-                cv::Point textPosition(30, 50); // x=30, y=50 from top-left
+    const std::string labels = "camera=\"" + device.serial() + "\"";
+    pipeline->attachMetrics(*metricsRegistry, labels);
+    displayLatency = metricsRegistry->histogram("dtx_display_latency_seconds", labels, "Sink pop to frame shown");
+    publishToDisplay = metricsRegistry->histogram("dtx_publish_to_display_seconds", labels, "Result publish to frame shown");
+
+    metricsCounters = metricsRegistry->addCounters([this, labels](std::vector<MetricSample>& samples) {
+        const SourceStatistics stats = statistics();
+        samples.push_back(MetricSample{ "dtx_source_delivered_total", labels, static_cast<double>(stats.delivered), false });
+        samples.push_back(MetricSample{ "dtx_device_underruns_total", labels, static_cast<double>(stats.deviceUnderruns), false });
+        samples.push_back(MetricSample{ "dtx_transmission_errors_total", labels, static_cast<double>(stats.transmissionErrors), false });
+        samples.push_back(MetricSample{ "dtx_sink_underruns_total", labels, static_cast<double>(stats.sinkUnderruns), false });
+        samples.push_back(MetricSample{ "dtx_sink_ignored_total", labels, static_cast<double>(stats.sinkIgnored), false });
+        samples.push_back(MetricSample{ "dtx_buffers_in_flight", labels, static_cast<double>(buffersInFlight()), true });
+    });
+}
 
-                // Font settings
-                int fontFace = cv::FONT_HERSHEY_SIMPLEX;
-                double fontScale = 1.5;
-                int thickness = 3;
+void TISCameraIC4::detachMetrics() {
+    if (metricsRegistry != nullptr && metricsCounters != 0) {
+        metricsRegistry->removeCounters(metricsCounters);
+    }
+    metricsCounters = 0;
+    displayLatency = nullptr;
+    publishToDisplay = nullptr;
+}
 
-                // Add background for better text visibility
-                cv::Size textSize = cv::getTextSize(statusText, fontFace, fontScale, thickness, 0);
-                cv::rectangle(currentFrame,
-                    textPosition - cv::Point(10, textSize.height + 5),
-                    textPosition + cv::Point(textSize.width + 10, 10),
-                    cv::Scalar(0, 0, 0), -1); 
+// Start grabbing into the inspection pipeline without any window (headless)
+bool TISCameraIC4::startInspection(ResultCallback onResult) {
+    if (!isConnected) {
+        std::cerr << "Camera not connected." << std::endl;
+        return false;
+    }
 
-                // Put the text on the image
-                cv::putText(currentFrame, statusText, textPosition,
-                    fontFace, fontScale, color, thickness);
+    if (isGrabbing) {
+        std::cout << "Already grabbing." << std::endl;
+        return true;
+    }
 
-                // Display the frame with text overlay
-                cv::imshow("Camera Feed", currentFrame);
+    // Each worker gets its own engine object; VisionMaster workers on the same procedure take turns
+    InspectionPipeline::EngineFactory factory = engineFactory;
+    if (!factory) {
+        factory = [] { return std::unique_ptr<IInspectionEngine>(new VisionMasterProcessor()); };
+    }
+    // Recording only copies into memory; the history and the log write from their own threads
+    FrameHistory* history = frameHistory;
+    ResultLog* log = resultLog;
+    ResultCallback publish = std::move(onResult);
+    if (history || log) {
+        publish = [history, log, publish](const InspectedFrame& inspected) {
+            if (log) {
+                log->append(inspected);
+            }
+            if (history) {
+                history->record(inspected);
             }
-            else {
-                // If no frame available, show a waiting message
-                cv::Mat waitingImage = cv::Mat::zeros(480, 640, CV_8UC3);
-                cv::putText(waitingImage, "Waiting for frames...", cv::Point(50, 240),
-                    cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(255, 255, 255), 2);
-                cv::imshow("Camera Feed", waitingImage);
+            if (publish) {
+                publish(inspected);
             }
+        };
+    }
+    pipeline.reset(new InspectionPipeline(pipelineConfig, factory, std::move(publish)));
+    attachMetrics();
+    if (!pipeline->start()) {
+        return false;
+    }
 
-            // Handle key presses
-            int key = cv::waitKey(1) & 0xFF;
+    // Inspection runs on the pipeline workers; the IC4 callback thread only hands the frame over
+    InspectionPipeline* inspection = pipeline.get();
+    if (!startStream([inspection](FrameHandle frame) { inspection->submit(std::move(frame)); })) {
+        pipeline->stop();
+        return false;
+    }
 
-            // Check for ESC key to exit
-            if (key == 27) {  // ESC key
-                std::cout << "ESC key pressed. Exiting display loop..." << std::endl;
-                break;
-            }
+    if (stateCallback) {
+        stateCallback(true);
+    }
+    return true;
+}
 
-            // Handle software trigger if trigger mode is enabled
-            if ((key == 's' || key == 'S') && triggerModeEnabled) {
-                if (!sendSoftwareTrigger()) {
-                    std::cerr << "Failed to send software trigger." << std::endl;
-                }
-            }
+// Stop the stream, then let the pipeline finish the frames it already has
+bool TISCameraIC4::stopInspection() {
+    if (!isGrabbing) {
+        return true;
+    }
 
-            // Handle 't' to toggle trigger mode
-            if (key == 't' || key == 'T') {
-                if (toggleTriggerMode()) {
-                    std::cout << "Trigger mode " << (triggerModeEnabled ? "ENABLED" : "DISABLED") << std::endl;
-                    displayTriggerInfo(); // Optional: show updated trigger info
-                }
-            }
+    const bool stopped = stopStream();
+    if (pipeline) {
+        pipeline->stop();
+    }
 
-            updateParameterDisplay();
-            
-        }
+    std::cout << "Stopped grabbing frames." << std::endl;
+    if (frameListener) {
+        std::cout << "Peak sink buffers in flight: " << frameListener->peakBuffersInFlight()
+            << " of " << frameListener->bufferCount() << std::endl;
+    }
+    if (pipeline) {
+        std::cout << "Frames inspected: " << pipeline->publishedCount()
+            << ", dropped: " << pipeline->droppedCount()
+            << ", failed: " << pipeline->failedCount()
+            << ", converted for inspection: " << pipeline->conversionFallbackCount() << std::endl;
+    }
+    SourceStatistics stats = statistics();
+    std::cout << "Device underruns: " << stats.deviceUnderruns
+        << ", transmission errors: " << stats.transmissionErrors
+        << ", sink underruns: " << stats.sinkUnderruns << std::endl;
+    if (frameHistory) {
+        std::cout << "History: " << frameHistory->recordedCount() << " frames recorded, "
+            << frameHistory->skippedCount() << " skipped, "
+            << frameHistory->archivesWrittenCount() << " archives written" << std::endl;
+    }
+    if (resultLog) {
+        std::cout << "Result log: " << resultLog->appendedCount() << " records, "
+            << resultLog->droppedCount() << " dropped" << std::endl;
+    }
+    if (metricsRegistry) {
+        std::cout << metricsRegistry->reportText();
+    }
 
-        // Cleanup after loop exits
-        isGrabbing = false;
-        cv::destroyWindow("Camera Feed");
-        cv::destroyWindow("Parameter Control");
+    if (stateCallback) {
+        stateCallback(false);
+    }
+    return stopped;
+}
+
+// Start grabbing frames with inspection, a live view and the parameter control window.
+// Blocks until the view is closed.
+bool TISCameraIC4::startGrabbing() {
+    // Outlives the pipeline, which hands it the results; it only takes the frames it has time to show
+    FrameViewer viewer(viewerConfig);
+
+    try {
+        // Initialize the parameter control window
+        initParameterControlWindow();
 
-        // Stop the stream
-        if (!grabber.streamStop(err)) {
-            std::cerr << "Error stopping stream: " << err.message() << std::endl;
+        if (!startInspection([&viewer](const InspectedFrame& inspected) { viewer.publish(inspected); })) {
+            cv::destroyWindow("Parameter Control");
+            return false;
         }
+        viewer.setLatencyHistograms(displayLatency, publishToDisplay);
 
-        std::cout << "Stopped grabbing frames." << std::endl;
-        return true;
+        std::cout << "Starting camera feed. Use the exposure slider in 'Parameter Control' window." << std::endl;
+        std::cout << "Press ESC to exit, 't' to toggle trigger mode, 's' to trigger (if trigger mode enabled), 'a' to archive the last frames..." << std::endl;
+
+        viewer.run(
+            [this](int key) {
+                // Handle 's' to send a software trigger if trigger mode is enabled
+                if ((key == 's' || key == 'S') && triggerModeEnabled && !sendSoftwareTrigger()) {
+                    std::cerr << "Failed to send software trigger." << std::endl;
+                }
+                // Handle 't' to toggle trigger mode
+                if ((key == 't' || key == 'T') && toggleTriggerMode()) {
+                    displayTriggerInfo();
+                }
+                // Handle 'a' to archive the last frames
+                if ((key == 'a' || key == 'A') && frameHistory && !frameHistory->archive()) {
+                    std::cerr << "Nothing to archive." << std::endl;
+                }
+                return true;
+            },
+            [this] {
+                applyPendingExposure();
+                updateParameterDisplay();
+            });
+
+        cv::destroyWindow("Parameter Control");
 
+        return stopInspection();
     }
     catch (const std::exception& e) {
         std::cerr << "Error during grabbing: " << e.what() << std::endl;
 
         // Cleanup on error
         cv::destroyAllWindows();
-        try {
-            grabber.streamStop();
-        }
-        catch (...) {
-            // Ignore cleanup errors
-        }
-        isGrabbing = false;
-
+        stopInspection();
         return false;
     }
 }
+
 // Stop grabbing
 bool TISCameraIC4::stopGrabbing() {
-    if (!isGrabbing) {
-        return true;
-    }
-
-    try {
-        grabber.streamStop();
-        isGrabbing = false;
-        std::cout << "Stopped grabbing frames." << std::endl;
-        return true;
-
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error stopping grab: " << e.what() << std::endl;
-        return false;
-    }
+    return stopInspection();
 }
 
 std::string TISCameraIC4::formatDeviceInfo(const ic4::DeviceInfo& device_info) {
@@ -496,21 +633,16 @@ bool TISCameraIC4::enableTriggerMode() {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-
-        // Set trigger mode to On
-        map.setValue(ic4::PropId::TriggerMode, "On");
-
-        triggerModeEnabled = true;
-        std::cout << "Trigger mode enabled." << std::endl;
-
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error enabling trigger mode: " << e.what() << std::endl;
+    // Set trigger mode to On
+    std::string error;
+    if (!properties.setEnumeration(properties.triggerMode, "On", error)) {
+        std::cerr << "Error enabling trigger mode: " << error << std::endl;
         return false;
     }
+
+    triggerModeEnabled = true;
+    std::cout << "Trigger mode enabled." << std::endl;
+    return true;
 }
 
 
@@ -538,21 +670,16 @@ bool TISCameraIC4::disableTriggerMode() {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-
-        // Set trigger mode to Off
-        map.setValue(ic4::PropId::TriggerMode, "Off");
-
-        triggerModeEnabled = false;
-        std::cout << "Trigger mode disabled (free-run mode)." << std::endl;
-
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error disabling trigger mode: " << e.what() << std::endl;
+    // Set trigger mode to Off
+    std::string error;
+    if (!properties.setEnumeration(properties.triggerMode, "Off", error)) {
+        std::cerr << "Error disabling trigger mode: " << error << std::endl;
         return false;
     }
+
+    triggerModeEnabled = false;
+    std::cout << "Trigger mode disabled (free-run mode)." << std::endl;
+    return true;
 }
 
 // Set trigger source
@@ -562,25 +689,19 @@ bool TISCameraIC4::setTriggerSource(const std::string& source) {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-
-        // First set trigger selector to frame start (most common)
-        map.setValue(ic4::PropId::TriggerSelector, "FrameStart");
+    // First set trigger selector to frame start (most common)
+    std::string error;
+    properties.setEnumeration(properties.triggerSelector, "FrameStart", error);
 
-        // Set trigger source
-        if (!map.setValue(ic4::PropId::TriggerSource, &source));
-            std::cout << "ERROR";
-
-        currentTriggerSource = source;
-        std::cout << "Trigger source set to: " << source << std::endl;
-
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error setting trigger source: " << e.what() << std::endl;
+    // Set trigger source
+    if (!properties.setEnumeration(properties.triggerSource, source, error)) {
+        std::cerr << "Error setting trigger source: " << error << std::endl;
         return false;
     }
+
+    currentTriggerSource = source;
+    std::cout << "Trigger source set to: " << source << std::endl;
+    return true;
 }
 
 // Send software trigger
@@ -595,45 +716,31 @@ bool TISCameraIC4::sendSoftwareTrigger() {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-
-        // Execute software trigger command
-        if (!map.executeCommand(ic4::PropId::TriggerSoftware)) {
-            std::cout << "ERROR" << std::endl;
-                
-        }
-
-        std::cout << "Software trigger sent." << std::endl;
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error sending software trigger: " << e.what() << std::endl;
+    // Execute software trigger command
+    std::string error;
+    if (!properties.execute(properties.triggerSoftware, error)) {
+        std::cerr << "Failed to send software trigger: " << error << std::endl;
         return false;
     }
+
+    DTX_LOG(Debug, "Software trigger sent.");
+    return true;
 }
 
 // Check if trigger mode is enabled
 bool TISCameraIC4::isTriggerModeEnabled() {
-    if (!isConnected) {
+    if (!isConnected || !properties.triggerMode.is_valid()) {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-        auto prop = map.find(ic4::PropId::TriggerMode);
-
-        if (prop.is_valid() && prop.isAvailable()) {
-            std::string mode = prop.getValue();
-            triggerModeEnabled = (mode == "On");
-            return triggerModeEnabled;
-        }
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error checking trigger mode: " << e.what() << std::endl;
+    ic4::Error err;
+    std::string mode = properties.triggerMode.getValue(err);
+    if (err.isError()) {
+        std::cerr << "Error checking trigger mode: " << err.message() << std::endl;
+        return false;
     }
-
-    return false;
+    triggerModeEnabled = (mode == "On");
+    return triggerModeEnabled;
 }
 
 // Configure trigger with common settings
@@ -643,31 +750,57 @@ bool TISCameraIC4::configureTrigger(const std::string& source, double delay) {
         return false;
     }
 
-    try {
-        auto map = grabber.devicePropertyMap();
-        map.setValue(ic4::PropId::TriggerMode, "Off");
-
-        ic4::Error err;
-
-        if (delay > 0.0) {
-            map.setValue(ic4::PropId::TriggerDelay, delay);
-        }
+    // One frame per trigger edge from 'source'. The delay is always written, so 0 clears an old
+    // one, clamped to what the device accepts; a device without TriggerDelay only fails for delay > 0.
+    CameraProfile profile;
+    profile.triggerSource = source;
+    if (properties.triggerDelay.is_valid()) {
+        const double minDelay = properties.triggerDelay.minimum(ic4::Error::Ignore());
+        profile.triggerDelayUs = std::max(std::max(0.0, minDelay), delay);
+    }
+    else if (delay > 0.0) {
+        profile.triggerDelayUs = delay;
+    }
+    profile.triggerMode = 1;
+    if (!applyProfile(profile)) {
+        return false;
+    }
 
-        // Enable trigger mode
-        map.setValue(ic4::PropId::TriggerMode, "On");
+    std::cout << "Trigger configured - Source: " << source
+        << ", Delay: " << std::max(0.0, profile.triggerDelayUs) << " μs" << std::endl;
+    return true;
+}
 
-        triggerModeEnabled = true;
-        currentTriggerSource = source;
+// Apply several parameters in one go through the cached handles
+bool TISCameraIC4::applyProfile(const CameraProfile& profile) {
+    if (!isConnected) {
+        std::cerr << "Camera not connected." << std::endl;
+        return false;
+    }
 
-        std::cout << "Trigger configured - Source: " << source
-            << ", Delay: " << delay << " μs" << std::endl;
+    std::string error;
+    const bool applied = properties.apply(profile, error);
+    if (!applied) {
+        std::cerr << "Failed to apply camera profile: " << error << std::endl;
+    }
 
-        return true;
+    // Keep the cached state in line with the device, also after a partial failure
+    if (profile.exposureUs >= 0.0) {
+        getExposure();
     }
-    catch (const std::exception& e) {
-        std::cerr << "Error configuring trigger: " << e.what() << std::endl;
-        return false;
+    if (profile.width > 0 && properties.width.is_valid()) {
+        width = static_cast<int>(properties.width.getValue(ic4::Error::Ignore()));
+    }
+    if (profile.height > 0 && properties.height.is_valid()) {
+        height = static_cast<int>(properties.height.getValue(ic4::Error::Ignore()));
+    }
+    if (!profile.triggerSource.empty() && properties.triggerSource.is_valid()) {
+        currentTriggerSource = properties.triggerSource.getValue(ic4::Error::Ignore());
+    }
+    if (profile.triggerMode >= 0 || !profile.triggerSource.empty() || profile.triggerDelayUs >= 0.0) {
+        isTriggerModeEnabled();
     }
+    return applied;
 }
 
 // Display trigger information
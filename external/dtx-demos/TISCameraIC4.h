@@ -3,23 +3,76 @@
 
 #include <ic4/ic4.h>
 #include <ic4-interop/interop-OpenCV.h>
-#include "VisionMasterProcessor.h"
 #include <string>
 #include <opencv2/opencv.hpp>
 #include <mutex>
 #include <atomic>
+#include <algorithm>
+#include <memory>
+#include "Frame.h"
+#include <functional>
+#include "ICameraSource.h"
+#include "InspectionPipeline.h"
+#include "FrameViewer.h"
+#include "IC4PropertyCache.h"
+#include "FrameHistory.h"
+#include "ResultLog.h"
 
-// Define QueueSinkListener-derived class that stores the latest frame
+// Define QueueSinkListener-derived class that hands every frame to a callback without copying it
 class GrabbingImage : public ic4::QueueSinkListener
 {
 private:
-    std::mutex frame_mutex_;
-    cv::Mat latest_frame_;
-    std::atomic<bool> new_frame_available_{ false };
-    VisionMasterProcessor processor;
+    ICameraSource::FrameCallback frame_callback_;
+    FrameTracker tracker_;
+    size_t buffer_count_;
+
+    static FramePixelFormat toFramePixelFormat(ic4::PixelFormat format)
+    {
+        switch (format)
+        {
+        case ic4::PixelFormat::Mono8: return FramePixelFormat::Mono8;
+        case ic4::PixelFormat::BGR8:  return FramePixelFormat::BGR8;
+        case ic4::PixelFormat::RGB8:  return FramePixelFormat::RGB8;
+        case ic4::PixelFormat::BGRa8: return FramePixelFormat::BGRa8;
+        default:                      return FramePixelFormat::Unknown;
+        }
+    }
+
+    // Describe the buffer's memory; the frame keeps the buffer alive instead of copying it
+    static Frame wrapBuffer(const std::shared_ptr<ic4::ImageBuffer>& buffer)
+    {
+        Frame frame;
+        auto type = buffer->imageType();
+        auto meta = buffer->metaData();
+        frame.frameNumber = meta.device_frame_number;
+        frame.deviceTimestampNs = meta.device_timestamp_ns;
+        frame.hostTimestampNs = steadyNowNs();
+        frame.image.data = static_cast<const uint8_t*>(buffer->ptr());
+        frame.image.width = type.width();
+        frame.image.height = type.height();
+        frame.image.stride = buffer->pitch();
+        frame.image.format = toFramePixelFormat(type.pixel_format());
+        frame.owner = buffer;
+        return frame;
+    }
 
 public:
-    GrabbingImage() = default;
+    // bufferCount: number of buffers allocated for the sink. Frames held by consumers
+    // are not available to the driver, so this has to cover peakBuffersInFlight().
+    GrabbingImage(size_t bufferCount, ICameraSource::FrameCallback callback)
+        : frame_callback_(std::move(callback)), buffer_count_(bufferCount) {}
+
+    // Inherited via QueueSinkListener, called when the sink is connected to the stream
+    bool sinkConnected(ic4::QueueSink& sink, const ic4::ImageType& imageType, size_t min_buffers_required) override
+    {
+        ic4::Error err;
+        if (!sink.allocAndQueueBuffers(std::max(buffer_count_, min_buffers_required), err))
+        {
+            std::cerr << "Failed to allocate sink buffers: " << err.message() << std::endl;
+            return false;
+        }
+        return true;
+    }
 
     // Inherited via QueueSinkListener, called when there are frames available in the sink's output queue
     void framesQueued(ic4::QueueSink& sink) override
@@ -36,54 +89,36 @@ public:
                 return;
             }
 
-            auto mat = ic4interop::OpenCV::wrap(*buffer);
-            processor.runProcedure();
-            processor.getResults();
-
-
-            // Store the latest frame with thread safety
-            {
-                std::lock_guard<std::mutex> lock(frame_mutex_);
-                latest_frame_ = mat.clone(); // Clone to ensure we have our own copy
-                new_frame_available_ = true;
-            }
-            
-        }
-    }
-
-    float getResult() {
-        CalculatorResults* res = processor.getCalculatorResults();
-        return res->GetResult(0)->pFloatValue[0];
-    }
-
-    // Get the latest frame (thread-safe)
-    bool getLatestFrame(cv::Mat& frame)
-    {
-        std::lock_guard<std::mutex> lock(frame_mutex_);
-        if (!latest_frame_.empty()) {
-            frame = latest_frame_.clone();
-            new_frame_available_ = false;
-            return true;
+            frame_callback_(tracker_.track(wrapBuffer(buffer)));
         }
-        return false;
     }
 
-    // Check if a new frame is available
-    bool isNewFrameAvailable() const
-    {
-        return new_frame_available_;
-    }
+    // Number of sink buffers currently held by consumers
+    size_t buffersInFlight() const { return tracker_.buffersInFlight(); }
+    // Highest number of sink buffers held at the same time
+    size_t peakBuffersInFlight() const { return tracker_.peakBuffersInFlight(); }
+    size_t bufferCount() const { return buffer_count_; }
 
 };
 
-class TISCameraIC4 {
+class TISCameraIC4 : public ICameraSource {
+public:
+    // Called on an inspection thread with every result, in frame order
+    using ResultCallback = InspectionPipeline::ResultCallback;
+    // Called when inspection starts (true) or has stopped (false)
+    using StateCallback = std::function<void(bool running)>;
+
 private:
     ic4::Grabber grabber;
     bool isConnected;
     bool isGrabbing;
     bool triggermodeEnabled = true;
     ic4::DeviceInfo device;
-    std::string formatDeviceInfo(const ic4::DeviceInfo& device_info);
+    static std::string formatDeviceInfo(const ic4::DeviceInfo& device_info);
+    // Open 'dev_info', load the default user set and read the exposure settings
+    bool openDevice(const ic4::DeviceInfo& dev_info);
+    // Property handles, resolved in openDevice
+    IC4PropertyCache properties;
 
     // Exposure control variables
     double minExposure;
@@ -94,54 +129,132 @@ private:
     int height = 480;
     bool triggerModeEnabled = false;
     std::string currentTriggerSource = "Software";
+    size_t sinkBufferCount = 8;
+    ic4::PixelFormat sinkPixelFormat = ic4::PixelFormat::RGB8; // Read by VisionMaster without conversion
+    PipelineConfig pipelineConfig;
+    InspectionPipeline::EngineFactory engineFactory;
 
     // Frame grabbing
     std::shared_ptr<GrabbingImage> frameListener;
     std::shared_ptr<ic4::QueueSink> queueSink;
 
+    // Inspection and the live view of startGrabbing
+    std::unique_ptr<InspectionPipeline> pipeline;
+    ViewerConfig viewerConfig;
+    StateCallback stateCallback;
+    FrameHistory* frameHistory = nullptr;
+    ResultLog* resultLog = nullptr;
+
+    // Parameter panel, allocated once and redrawn only when a shown value changes
+    cv::Mat controlPanel;
+    double panelExposure = 0.0;
+    bool panelTriggerMode = false;
+    std::string panelTriggerSource;
+
+    // Stage latencies and counters, labelled with the camera serial (optional)
+    MetricsRegistry* metricsRegistry = nullptr;
+    int metricsCounters = 0;
+    LatencyHistogram* displayLatency = nullptr;   // Sink pop -> shown
+    LatencyHistogram* publishToDisplay = nullptr; // Result published -> shown
+    void attachMetrics();
+    void detachMetrics();
+
     // Static callback function for trackbar
     static void onExposureChange(int value, void* userdata);
+    // Latest slider position not applied yet, -1 = none
+    std::atomic<int> pendingSliderValue{ -1 };
+    void applyPendingExposure();
 
 public:
     TISCameraIC4();
-    ~TISCameraIC4();
+    ~TISCameraIC4() override;
 
     // List available cameras using IC4
     void listCameras();
     // Connect to camera by index
     bool connect(int cameraIndex = 0);
+    // Connect to the camera with this serial number (stable across reboots, unlike the index)
+    bool connectBySerial(const std::string& serial);
     // Disconnect camera
     void disconnect();
-    // Set exposure time in microseconds
-    bool setExposure(double exposureUs);
-    // Get current exposure value
-    double getExposure();
-    // Get exposure range
-    bool getExposureRange(double& min, double& max);
-    // Display current exposure information
-    void displayExposureInfo();
-    // Start grabbing frames with parameter control window
+    // Start streaming into 'callback' without inspection or display (ICameraSource)
+    bool startStream(FrameCallback callback) override;
+    // Stop streaming (ICameraSource)
+    bool stopStream() override;
+    bool streaming() const override { return isGrabbing; }
+    std::string description() const override;
+    // Start streaming into the inspection pipeline and return; every result goes to 'onResult'.
+    // No window is opened, so this also runs without a display.
+    bool startInspection(ResultCallback onResult);
+    // Stop the stream, finish the queued frames and print the statistics
+    bool stopInspection();
+    // Notified when inspection starts and stops
+    void setStateCallback(StateCallback callback) { stateCallback = std::move(callback); }
+    // Start inspection with a live view and parameter control window; blocks until ESC
     bool startGrabbing();
     // Stop grabbing
     bool stopGrabbing();
+    // Rate and size of the live view of startGrabbing
+    void setViewerConfig(const ViewerConfig& config) { viewerConfig = config; }
     // Check if camera is connected
     bool connected() const { return isConnected; }
     // Check if camera is grabbing
     bool grabbing() const { return isGrabbing; }
+    // Image size set on the device when streaming starts
+    void setResolution(int w, int h) { width = w; height = h; }
+    // Number of buffers allocated for the queue sink (applies to the next startInspection)
+    void setSinkBufferCount(size_t count) { sinkBufferCount = count; }
+    // Pixel format delivered by the sink (applies to the next startInspection). VisionMaster reads
+    // RGB8 (the default) and Mono8 (monochrome solutions) directly; BGR8 is converted per frame.
+    void setSinkPixelFormat(ic4::PixelFormat format) { sinkPixelFormat = format; }
+    // Inspection workers, queue size and backpressure policy (applies to the next startInspection)
+    void setPipelineConfig(const PipelineConfig& config) { pipelineConfig = config; }
+    // Inspection backend for startInspection, one instance per worker (default: VisionMasterProcessor)
+    void setEngineFactory(InspectionPipeline::EngineFactory factory) { engineFactory = std::move(factory); }
+    // Sink buffers currently held by the display/inspection
+    size_t buffersInFlight() const override { return frameListener ? frameListener->buffersInFlight() : 0; }
+    // Highest number of sink buffers held at the same time during grabbing
+    size_t peakBuffersInFlight() const override { return frameListener ? frameListener->peakBuffersInFlight() : 0; }
+    // Driver and sink counters of the current stream
+    SourceStatistics statistics() override;
+    // Record stage latencies, dropped frames and sink underruns in 'registry' (applies to the
+    // next startInspection, nullptr = off). The registry has to outlive the camera.
+    void setMetricsRegistry(MetricsRegistry* registry) { metricsRegistry = registry; }
+    // Keep the last frames and archive NOKs (applies to the next startInspection, nullptr = off).
+    // The history has to be started and has to outlive the inspection.
+    void setFrameHistory(FrameHistory* history) { frameHistory = history; }
+    // Append every result to an open result log (applies to the next startInspection, nullptr = off)
+    void setResultLog(ResultLog* log) { resultLog = log; }
+
+    // Exposure and trigger control. None of these needs a window, so they can be used
+    // while startInspection() runs headless.
+    // Set exposure time in microseconds
+    bool setExposure(double exposureUs) override;
+    // Get current exposure value
+    double getExposure() override;
+    // Get exposure range
+    bool getExposureRange(double& min, double& max);
+    // Display current exposure information
+    void displayExposureInfo();
     bool toggleAutoExposureMode();
-    // Initialize parameter control window
-    void initParameterControlWindow();
-    // Update slider from current exposure value
-    void updateSliderFromExposure();
-    void updateParameterDisplay();
     bool enableTriggerMode();
-    bool disableTriggerMode();
+    bool disableTriggerMode() override;
     bool toggleTriggerMode();
     bool setTriggerSource(const std::string& source = "Software"); // "Software", "Line1", etc.
-    bool sendSoftwareTrigger();
+    bool sendSoftwareTrigger() override;
     bool isTriggerModeEnabled();
     void displayTriggerInfo();
     // Trigger configuration
-    bool configureTrigger(const std::string& source = "Software", double delay = 0.0);
+    bool configureTrigger(const std::string& source = "Software", double delay = 0.0) override;
+    // Apply exposure, gain, ROI and trigger settings together (see CameraProfile)
+    bool applyProfile(const CameraProfile& profile);
+
+    // Parameter control window of startGrabbing (HighGUI thread only)
+    // Initialize parameter control window
+    void initParameterControlWindow();
+    // Update slider from current exposure value
+    void updateSliderFromExposure();
+    // Redraw the panel if the exposure or trigger settings changed
+    void updateParameterDisplay();
 };
 #endif // TISCAMERAIC4_H
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "TriggerBurst.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+std::string TriggerBurstReport::text() const {
+    size_t frames = 0;
+    size_t okCount = 0;
+    size_t nokCount = 0;
+    for (const TriggerRecord& record : triggers) {
+        frames += record.matched ? 1 : 0;
+        if (record.inspected && record.valid) {
+            ++(record.ok ? okCount : nokCount);
+        }
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "Triggers: " << triggers.size() << ", frames: " << frames
+        << ", missed triggers: " << missedTriggers
+        << ", unmatched frames: " << unmatchedFrames
+        << ", not inspected: " << uninspected << "\n";
+    out << "Verdicts: OK " << okCount << ", NOK " << nokCount << "\n";
+    out << "Trigger -> frame:  p50=" << triggerToFrame.percentile(0.5) * 1e-6 << "ms"
+        << " p99=" << triggerToFrame.percentile(0.99) * 1e-6 << "ms"
+        << " max=" << triggerToFrame.max * 1e-6 << "ms\n";
+    out << "Trigger -> result: p50=" << triggerToResult.percentile(0.5) * 1e-6 << "ms"
+        << " p99=" << triggerToResult.percentile(0.99) * 1e-6 << "ms"
+        << " max=" << triggerToResult.max * 1e-6 << "ms\n";
+    return out.str();
+}
+
+bool TriggerBurstReport::writeCsv(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    file << "trigger_id,trigger_ns,frame_number,trigger_to_frame_ms,trigger_to_result_ms,valid,ok,value\n";
+    file << std::fixed << std::setprecision(3);
+    for (const TriggerRecord& record : triggers) {
+        const uint64_t startNs = record.triggerNs != 0 ? record.triggerNs : record.frameNs;
+        file << record.id << "," << record.triggerNs << ",";
+        if (record.matched) {
+            file << record.frameNumber << "," << (record.triggerNs != 0 ? (record.frameNs - record.triggerNs) * 1e-6 : 0.0);
+        }
+        else {
+            file << ",";
+        }
+        file << ",";
+        if (record.inspected) {
+            file << (record.resultNs - startNs) * 1e-6 << "," << record.valid << "," << record.ok << "," << record.value;
+        }
+        else {
+            file << ",,,";
+        }
+        file << "\n";
+    }
+    return true;
+}
+
+TriggerBurst::TriggerBurst(ICameraSource& camera, const TriggerBurstConfig& config)
+    : camera(camera), config(config) {
+}
+
+size_t TriggerBurst::addTriggerLocked(uint64_t triggerNs) {
+    TriggerRecord record;
+    record.id = records.size();
+    record.triggerNs = triggerNs;
+    records.push_back(record);
+    waiting.push_back(record.id);
+    return record.id;
+}
+
+void TriggerBurst::expireLocked(uint64_t nowNs) {
+    const uint64_t timeoutNs = static_cast<uint64_t>(config.timeoutMs * 1e6);
+    while (!waiting.empty()) {
+        const TriggerRecord& oldest = records[waiting.front()];
+        if (oldest.triggerNs == 0 || nowNs < oldest.triggerNs || nowNs - oldest.triggerNs <= timeoutNs) {
+            break;
+        }
+        ++missed;
+        waiting.pop_front();
+    }
+}
+
+void TriggerBurst::missOldestLocked(uint64_t count) {
+    for (; count > 0 && !waiting.empty(); --count) {
+        ++missed;
+        waiting.pop_front();
+    }
+}
+
+ICameraSource::FrameCallback TriggerBurst::wrap(ICameraSource::FrameCallback downstream) {
+    return [this, downstream](FrameHandle frame) {
+        if (frame) {
+            // Read before taking the lock, the camera may take its own
+            const uint64_t cameraMissed = camera.statistics().missedTriggers;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (active) {
+                expireLocked(frame->hostTimestampNs);
+
+                // Triggers the camera skipped, and triggers whose frame was lost on the way
+                if (cameraMissed > cameraMissedTriggers) {
+                    missOldestLocked(cameraMissed - cameraMissedTriggers);
+                }
+                cameraMissedTriggers = cameraMissed;
+                if (haveFrameNumber && frame->frameNumber > lastFrameNumber + 1) {
+                    missOldestLocked(frame->frameNumber - lastFrameNumber - 1);
+                }
+                haveFrameNumber = true;
+                lastFrameNumber = frame->frameNumber;
+
+                size_t index = records.size();
+                if (config.source == "Line1" && !observedTriggers) {
+                    // Hardware triggers are not seen by the host: every frame is the next trigger
+                    if (records.size() < config.count) {
+                        index = addTriggerLocked(0);
+                        waiting.pop_back();
+                    }
+                }
+                else if (!waiting.empty()) {
+                    // Oldest trigger first; a trigger fired too shortly before the frame cannot have caused it
+                    const uint64_t latestTriggerNs = frame->hostTimestampNs > minFrameLatencyNs ?
+                        frame->hostTimestampNs - minFrameLatencyNs : 0;
+                    if (records[waiting.front()].triggerNs <= latestTriggerNs) {
+                        index = waiting.front();
+                        waiting.pop_front();
+                    }
+                }
+
+                if (index < records.size()) {
+                    TriggerRecord& record = records[index];
+                    record.matched = true;
+                    record.frameNumber = frame->frameNumber;
+                    record.frameNs = frame->hostTimestampNs;
+                    byFrameNumber[record.frameNumber] = index;
+                    ++resultsPending;
+                    triggerToFrame.recordInterval(record.triggerNs, record.frameNs);
+                }
+                else {
+                    ++unmatched;
+                }
+                progress.notify_all();
+            }
+        }
+        if (downstream) {
+            downstream(std::move(frame));
+        }
+    };
+}
+
+void TriggerBurst::onResult(const InspectedFrame& inspected) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = byFrameNumber.find(inspected.result.frameNumber);
+    if (it == byFrameNumber.end()) {
+        return;
+    }
+
+    TriggerRecord& record = records[it->second];
+    byFrameNumber.erase(it);
+    record.inspected = true;
+    record.valid = inspected.result.valid;
+    record.ok = inspected.result.ok;
+    record.value = inspected.result.value;
+    record.resultNs = inspected.result.publishNs != 0 ? inspected.result.publishNs : steadyNowNs();
+    triggerToResult.recordInterval(record.triggerNs != 0 ? record.triggerNs : record.frameNs, record.resultNs);
+    --resultsPending;
+    progress.notify_all();
+}
+
+void TriggerBurst::onTrigger(uint64_t triggerNs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!active || records.size() >= config.count) {
+        return;
+    }
+    observedTriggers = true;
+    addTriggerLocked(triggerNs);
+    progress.notify_all();
+}
+
+TriggerBurstReport TriggerBurst::run() {
+    using clock = std::chrono::steady_clock;
+    TriggerBurstReport report;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        records.clear();
+        records.reserve(config.count);
+        waiting.clear();
+        byFrameNumber.clear();
+        byFrameNumber.reserve(config.count);
+        missed = 0;
+        unmatched = 0;
+        resultsPending = 0;
+        haveFrameNumber = false;
+        cameraMissedTriggers = camera.statistics().missedTriggers;
+        observedTriggers = false;
+    }
+
+    // By default a frame needs at least the delay and the exposure time after its trigger
+    double minLatencyMs = config.minFrameLatencyMs;
+    if (minLatencyMs < 0.0) {
+        minLatencyMs = (config.delayUs + std::max(0.0, camera.getExposure())) * 1e-3;
+    }
+
+    if (!camera.configureTrigger(config.source, config.delayUs)) {
+        std::cerr << "Failed to configure " << config.source << " trigger." << std::endl;
+        return report;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        minFrameLatencyNs = static_cast<uint64_t>(minLatencyMs * 1e6);
+        active = true;
+    }
+
+    const auto period = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(1.0 / (config.rateHz > 0.0 ? config.rateHz : 1.0)));
+    const auto timeout = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double, std::milli>(config.timeoutMs));
+
+    if (config.source == "Software") {
+        auto next = clock::now();
+        for (size_t i = 0; i < config.count; ++i) {
+            std::this_thread::sleep_until(next);
+            next += period;
+
+            // Recorded before it is sent, so the frame can never arrive first
+            size_t index = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                index = addTriggerLocked(steadyNowNs());
+            }
+            if (!camera.sendSoftwareTrigger()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!waiting.empty() && waiting.back() == index) {
+                    waiting.pop_back();
+                    ++missed;
+                }
+            }
+        }
+    }
+    else {
+        // Wait for the line (or the frames) at the nominal rate, plus the timeout
+        std::unique_lock<std::mutex> lock(mutex);
+        std::cout << "Armed for " << config.count << " " << config.source << " triggers." << std::endl;
+        progress.wait_until(lock, clock::now() + period * config.count + timeout,
+            [this] { return records.size() >= config.count; });
+    }
+
+    // Let the last frames and results come in
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        progress.wait_until(lock, clock::now() + 2 * timeout,
+            [this] { return waiting.empty() && resultsPending == 0; });
+
+        missed += waiting.size();
+        waiting.clear();
+        if (config.source != "Software" && !observedTriggers) {
+            missed += config.count - records.size();
+        }
+        active = false;
+
+        report.triggers = records;
+        report.missedTriggers = missed;
+        report.unmatchedFrames = unmatched;
+        report.uninspected = resultsPending;
+    }
+    report.triggerToFrame = triggerToFrame.snapshot();
+    report.triggerToResult = triggerToResult.snapshot();
+
+    camera.disableTriggerMode();
+    return report;
+}
@@ -0,0 +1,116 @@
+#ifndef TRIGGERBURST_H
+#define TRIGGERBURST_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ICameraSource.h"
+#include "InspectionResult.h"
+#include "LatencyHistogram.h"
+
+struct TriggerBurstConfig {
+    std::string source = "Software"; // "Software": fire 'count' triggers at 'rateHz'; "Line1": arm and wait
+    size_t count = 100;
+    double rateHz = 10.0;
+    double delayUs = 0.0;            // Camera trigger delay
+    double timeoutMs = 500.0;        // A trigger without a frame within this is missed
+    // Shortest possible trigger -> frame time; a frame never belongs to a trigger fired
+    // later than this before it. < 0 = trigger delay + the camera's exposure time.
+    double minFrameLatencyMs = -1.0;
+};
+
+// One trigger and what came back for it. Times are steadyNowNs(), 0 if unknown.
+struct TriggerRecord {
+    uint64_t id = 0;           // Trigger sequence id, 0..count-1
+    uint64_t triggerNs = 0;    // Fired (software) or observed on the line (hardware)
+    bool matched = false;      // A frame arrived for this trigger
+    uint64_t frameNumber = 0;
+    uint64_t frameNs = 0;      // Frame popped from the sink
+    bool inspected = false;    // Its result was published
+    bool valid = false;
+    bool ok = false;
+    float value = 0.0f;
+    uint64_t resultNs = 0;     // Result published
+};
+
+struct TriggerBurstReport {
+    std::vector<TriggerRecord> triggers;
+    size_t missedTriggers = 0;   // No frame within the timeout
+    size_t unmatchedFrames = 0;  // Frames that belong to no trigger (late, spurious or free run)
+    size_t uninspected = 0;      // Matched, but no result (dropped by the pipeline or still running)
+    HistogramSnapshot triggerToFrame;
+    HistogramSnapshot triggerToResult;
+
+    // Summary with p50/p99/max cycle latencies
+    std::string text() const;
+    // One line per trigger: id, trigger time, frame number, verdict, latencies
+    bool writeCsv(const std::string& path) const;
+};
+
+// Fires or arms a burst of triggers and correlates every trigger with its frame, verdict
+// and latency. Frames are matched to triggers in firing order: the oldest waiting trigger
+// takes the next frame, provided it was fired at least minFrameLatencyMs before it.
+// A trigger counts as missed only if it times out, if the frame numbers skip (the frame
+// for it was lost), or if the camera's missed-trigger counter goes up; those misses are
+// charged to the oldest waiting triggers, as a camera processes its triggers in order.
+//
+//   TriggerBurst burst(camera, config);
+//   camera.startStream(burst.wrap([&](FrameHandle f) { pipeline.submit(std::move(f)); }));
+//   ... pipeline result callback calls burst.onResult(inspected) ...
+//   TriggerBurstReport report = burst.run();
+//
+// Hardware triggers are not visible to the host; call onTrigger() when the line is seen
+// (I/O card, simulator). Without it, frames in Line1 mode are numbered in arrival order,
+// latency is measured from the frame instead of the trigger, and missed triggers are the
+// expected count minus the frames received.
+class TriggerBurst {
+private:
+    ICameraSource& camera;
+    TriggerBurstConfig config;
+
+    mutable std::mutex mutex;
+    std::condition_variable progress;
+    std::vector<TriggerRecord> records;
+    std::deque<size_t> waiting;                          // Triggers without a frame yet, oldest first
+    std::unordered_map<uint64_t, size_t> byFrameNumber;  // Frame number -> record
+    size_t missed = 0;
+    size_t unmatched = 0;
+    size_t resultsPending = 0;
+    uint64_t minFrameLatencyNs = 0;
+    bool haveFrameNumber = false;
+    uint64_t lastFrameNumber = 0;
+    uint64_t cameraMissedTriggers = 0; // Camera counter at the last frame
+    bool observedTriggers = false;
+    bool active = false;
+
+    LatencyHistogram triggerToFrame;
+    LatencyHistogram triggerToResult;
+
+    // Mark waiting triggers older than the timeout as missed. Caller holds the mutex.
+    void expireLocked(uint64_t nowNs);
+    // Mark the 'count' oldest waiting triggers as missed. Caller holds the mutex.
+    void missOldestLocked(uint64_t count);
+    size_t addTriggerLocked(uint64_t triggerNs);
+
+public:
+    TriggerBurst(ICameraSource& camera, const TriggerBurstConfig& config);
+
+    // Wrap the stream's frame callback so every frame is matched before it is passed on
+    ICameraSource::FrameCallback wrap(ICameraSource::FrameCallback downstream);
+    // Report a published result (call from the pipeline's result callback)
+    void onResult(const InspectedFrame& inspected);
+    // Report a hardware trigger seen on the line at 'triggerNs'
+    void onTrigger(uint64_t triggerNs);
+
+    // Configure the camera's trigger, fire or wait for 'count' triggers, wait for the last
+    // results and switch the camera back to free run. The stream has to be running.
+    // Call once per TriggerBurst; the latency histograms are not reset.
+    TriggerBurstReport run();
+};
+
+#endif // TRIGGERBURST_H
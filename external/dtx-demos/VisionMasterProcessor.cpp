@@ -1,13 +1,20 @@
 #include "VisionMasterProcessor.h"
+#include "Log.h"
 #include <sstream>
+#include <cstring>
+#include <mutex>
 
 VisionMasterProcessor::VisionMasterProcessor(const string& solPath, const string& procName,
     const string& imgSourceName, const string& varCalcName)
     : solutionPath(solPath), procedureName(procName), moduleImageSourceName(imgSourceName),
     moduleVaribleCalculation1(varCalcName), pVmSol(nullptr), pVmPrc(nullptr),
-    ImageSourceModule(nullptr), VariableCalculation1Module(nullptr), VC1Result(nullptr) {
-    initializeSolution();
-    loadModules();
+    ImageSourceModule(nullptr), VariableCalculation1Module(nullptr), VC1Result(nullptr), runMutex(nullptr) {
+    // Only the first instance loads the solution, the others look up their handles in it
+    std::lock_guard<std::mutex> lock(solutionMutex());
+    runMutex = &procedureMutex(procedureName);
+    if (initializeSolution()) {
+        loadModules();
+    }
 }
 
 VisionMasterProcessor::~VisionMasterProcessor() {
@@ -15,21 +22,47 @@ VisionMasterProcessor::~VisionMasterProcessor() {
     // Note: Specific cleanup depends on Vision Master SDK requirements
 }
 
-bool VisionMasterProcessor::initializeSolution() {
-    pVmSol = CreateSolutionInstance();
-    pVmSol = GetSolutionExistedInstance();
+std::mutex& VisionMasterProcessor::solutionMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
 
-    pVmSol = LoadSolution(solutionPath.c_str(), "");
-    if (NULL == pVmSol) {
-        std::cerr << "Failed to load solution!" << std::endl;
-        return false;
+std::mutex& VisionMasterProcessor::procedureMutex(const string& procedure) {
+    static std::map<string, std::unique_ptr<std::mutex>> mutexes;
+    std::unique_ptr<std::mutex>& mutex = mutexes[procedure];
+    if (!mutex) {
+        mutex.reset(new std::mutex());
     }
-    else {
-        std::cout << "LoadSolution success!" << std::endl;
-        return true;
+    return *mutex;
+}
+
+IVmSolution* VisionMasterProcessor::sharedSolution(const string& path) {
+    static IVmSolution* solution = nullptr;
+    static string loadedPath;
+
+    if (solution != nullptr) {
+        if (path != loadedPath) {
+            std::cerr << "Solution " << loadedPath << " is already loaded, cannot load " << path << "!" << std::endl;
+            return nullptr;
+        }
+        return solution;
     }
 
-	
+    CreateSolutionInstance();
+    GetSolutionExistedInstance();
+    solution = LoadSolution(path.c_str(), "");
+    if (NULL == solution) {
+        std::cerr << "Failed to load solution!" << std::endl;
+        return nullptr;
+    }
+    std::cout << "LoadSolution success!" << std::endl;
+    loadedPath = path;
+    return solution;
+}
+
+bool VisionMasterProcessor::initializeSolution() {
+    pVmSol = sharedSolution(solutionPath);
+    return pVmSol != nullptr;
 }
 
 bool VisionMasterProcessor::loadModules() {
@@ -70,32 +103,127 @@ bool VisionMasterProcessor::loadModules() {
 
 bool VisionMasterProcessor::runProcedure() {
     if (pVmPrc == nullptr) {
-        std::cerr << "Procedure not initialized!" << std::endl;
+        DTX_LOG(Error, "Procedure not initialized!");
         return false;
     }
 
     pVmPrc->Run();
-    std::cout << "Procedure executed successfully!" << std::endl;
+    DTX_LOG(Debug, "Procedure executed successfully!");
     return true;
 }
 
 bool VisionMasterProcessor::getResults() {
     if (VariableCalculation1Module == nullptr) {
-        std::cerr << "Variable Calculation module not initialized!" << std::endl;
+        DTX_LOG(Error, "Variable Calculation module not initialized!");
         return false;
     }
 
     VC1Result = VariableCalculation1Module->GetResult();
     if (VC1Result == nullptr) {
-        std::cout << "Failed to get Variable Calculation 1 results" << std::endl;
+        DTX_LOG(Error, "Failed to get Variable Calculation 1 results");
         return false;
     }
     else {
-        std::cout << "Got the results" << std::endl;
+        DTX_LOG(Debug, "Got the results");
         return true;
     }
 }
 
+EngineInputCaps VisionMasterProcessor::imageSourceCaps() {
+    EngineInputCaps caps;
+    caps.mono8 = true;
+    caps.rgb8 = true;
+    caps.bgr8 = false;
+    caps.paddedRows = false; // ImageBaseData has no stride field
+    return caps;
+}
+
+bool VisionMasterProcessor::runOnFrame(const ImageView& image, InspectionResult& result) {
+    result.valid = false;
+
+    if (ImageSourceModule == nullptr) {
+        DTX_LOG(Error, "Image Source module not initialized!");
+        return false;
+    }
+
+    bool converted = false;
+    ImageView input = prepareEngineInput(image, imageSourceCaps(), conversionBuffer, converted);
+    if (converted) {
+        ++conversionFallbacks;
+    }
+    if (input.format == FramePixelFormat::Unknown) {
+        DTX_LOG(Error, "Image format not supported by the Image Source module!");
+        return false;
+    }
+
+    // Image Source1 has to be set to SDK input in the solution, so it reads this
+    // buffer instead of its configured file or camera.
+    ImageBaseData imageData;
+    memset(&imageData, 0, sizeof(imageData));
+    imageData.ImageData = const_cast<unsigned char*>(input.data);
+    imageData.DataLen = static_cast<int>(input.stride * input.height);
+    imageData.Width = input.width;
+    imageData.Height = input.height;
+    imageData.Pixelformat = (input.format == FramePixelFormat::Mono8) ? MVD_PIXEL_MONO_08 : MVD_PIXEL_RGB_RGB24_C3;
+
+    // Image Source, procedure and result module are shared by every instance on this procedure:
+    // set, run and read back as one step, so the result always belongs to this image
+    std::lock_guard<std::mutex> lock(*runMutex);
+    try {
+        ImageSourceModule->SetImageData(&imageData);
+    }
+    catch (const CVmException& e) {
+        DTX_LOG(Error, "Failed to set image data: " << e.GetErrorCode());
+        return false;
+    }
+
+    if (!runProcedure() || !getResults()) {
+        return false;
+    }
+
+    CalOutputResultInfo* info = VC1Result->GetResult(0);
+    if (info == nullptr || info->pFloatValue == nullptr || info->nValueNum < 1) {
+        DTX_LOG(Error, "Variable Calculation result has no float value!");
+        return false;
+    }
+
+    result.value = info->pFloatValue[0];
+    result.ok = result.value == 1.0f;
+    result.valid = true;
+
+    // Keep every parameter for the result log, not only the verdict
+    result.outputs.clear();
+    const int paramCount = VC1Result->GetResultNum();
+    for (int i = 0; i < paramCount; ++i) {
+        // Parameters without values keep their slot, the log and the CSV index them by position
+        CalOutputResultInfo* param = VC1Result->GetResult(i);
+        if (param == nullptr || param->nValueNum < 1) {
+            result.outputs.addEmpty(false);
+        }
+        else if (param->nParamType == 1) {
+            if (param->pIntValue != nullptr) {
+                result.outputs.add(ResultValues::Int, param->pIntValue, param->nValueNum);
+            }
+            else {
+                result.outputs.addEmpty(false);
+            }
+        }
+        else if (param->nParamType == 2) {
+            if (param->pFloatValue != nullptr) {
+                result.outputs.add(ResultValues::Float, param->pFloatValue, param->nValueNum);
+            }
+            else {
+                result.outputs.addEmpty(false);
+            }
+        }
+        else {
+            result.outputs.addEmpty(true);
+        }
+    }
+    DTX_LOG(Debug, "Frame " << result.sequence << ": " << (result.ok ? "OK" : "NOK") << " (" << result.value << ")");
+    return true;
+}
+
 void VisionMasterProcessor::displayResults() {
     if (VC1Result == nullptr) {
         std::cerr << "No results available to display!" << std::endl;
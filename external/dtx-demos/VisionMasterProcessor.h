@@ -4,6 +4,14 @@
 #include <iostream>
 #include <string>
 #include <stdexcept>
+#include <vector>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "IInspectionEngine.h"
+#include "ImageConversion.h"
 
 #include "IVmSolution.h"
 #include "VMException.h"
@@ -18,7 +26,7 @@ using namespace VisionMasterSDK::VmProcedure;
 using namespace VisionMasterSDK::ImageSourceModule;
 using namespace VisionMasterSDK::CalculatorModule;
 
-class VisionMasterProcessor {
+class VisionMasterProcessor : public IInspectionEngine {
 private:
     IVmSolution* pVmSol;
     IVmProcedure* pVmPrc;
@@ -31,9 +39,33 @@ private:
     string moduleImageSourceName;
     string moduleVaribleCalculation1;
 
+    // Reused when a frame has to be converted before the Image Source module can take it
+    std::vector<uint8_t> conversionBuffer;
+    std::atomic<uint64_t> conversionFallbacks{ 0 };
+
+    // VisionMaster holds one solution per process, shared by every instance (every worker of
+    // every camera). Loading it and looking up handles in it hold this lock.
+    static std::mutex& solutionMutex();
+
+    // Procedures run in parallel, but one procedure (its Image Source and result module) takes
+    // one image at a time: instances on the same procedure share its lock for the set image /
+    // run / read result sequence. Caller holds solutionMutex().
+    static std::mutex& procedureMutex(const string& procedure);
+    std::mutex* runMutex;
+
+    // The solution of the process, loaded by the first instance only: loading it again would
+    // invalidate the procedure and module handles the other instances hold. Fails for a second,
+    // different path. Caller holds solutionMutex().
+    static IVmSolution* sharedSolution(const string& path);
+
+    // Layouts the Image Source module reads directly: Mono8 and packed RGB24, without row padding
+    static EngineInputCaps imageSourceCaps();
+
 public:
-    // Constructor
-    VisionMasterProcessor(const string& solPath = "C:\\Users\\User\\Desktop\\The-Imaging-Source-Camera-SDKs\\external\\dtx-demos\\ok_nok.solw",
+    // Constructor. A relative solution path is resolved against the working directory
+    // (the project directory when started from Visual Studio). Instances on different
+    // procedures inspect in parallel, instances on the same procedure take turns.
+    VisionMasterProcessor(const string& solPath = "ok_nok.solw",
         const string& procName = "Flow1",
         const string& imgSourceName = "Image Source1",
         const string& varCalcName = "Variable Calculation1");
@@ -41,7 +73,7 @@ public:
     // Destructor
     ~VisionMasterProcessor();
 
-    // Initialize the Vision Master solution
+    // Attach to the Vision Master solution, loading it if no instance has yet
     bool initializeSolution();
 
     // Load and configure modules
@@ -53,6 +85,13 @@ public:
     // Get and display results
     bool getResults();
 
+    // Hand the image to the Image Source module, run the procedure and return the verdict.
+    // The camera buffer is passed by pointer; it is only converted if the module cannot read it.
+    bool runOnFrame(const ImageView& image, InspectionResult& result) override;
+
+    // Number of frames that had to be converted for the Image Source module
+    uint64_t conversionFallbackCount() const override { return conversionFallbacks.load(); }
+
     // Display detailed results
     void displayResults();
 
@@ -0,0 +1,303 @@
+// Headless grab -> inspect benchmark on the synthetic source and the mock engine.
+// Runs without the IC4 and VisionMaster SDKs.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "CameraManager.h"
+#include "FrameHistory.h"
+#include "InspectionPipeline.h"
+#include "MetricsExporter.h"
+#include "MockInspectionEngine.h"
+#include "ResultLog.h"
+#include "SyntheticCameraSource.h"
+#include "TriggerBurst.h"
+
+static void printUsage() {
+    std::cout << "Usage: dtx-bench [options]\n"
+        << "  --width N            Frame width (default 640)\n"
+        << "  --height N           Frame height (default 480)\n"
+        << "  --format mono8|rgb8|bgr8 Pixel format (default rgb8, like the camera sink)\n"
+        << "  --fps F              Frame rate, 0 = as fast as possible (default 30)\n"
+        << "  --buffers N          Source buffer count (default 8)\n"
+        << "  --replay PATH        Replay a directory of images, an image or a video\n"
+        << "  --seconds S          Run time (default 5)\n"
+        << "  --workers N          Inspection workers (default 2)\n"
+        << "  --queue N            Inspection queue capacity (default 4)\n"
+        << "  --policy drop-oldest|drop-newest|block (default drop-oldest)\n"
+        << "  --latency-ms F       Mock inspection time (default 5)\n"
+        << "  --jitter-ms F        Mock inspection time spread (default 1)\n"
+        << "  --engine-bgr8        Mock engine reads BGR8 without conversion\n"
+        << "  --metrics-port N     Serve Prometheus metrics on 127.0.0.1:N while running\n"
+        << "  --metrics-file PATH  Write Prometheus metrics to PATH every second\n"
+        << "  --cameras PATH       Run every camera of a config file (synthetic sources only)\n"
+        << "  --trigger-burst N    Fire N triggers instead of free running, report per-trigger latency\n"
+        << "  --trigger-rate HZ    Burst trigger rate, also the simulated Line1 pulse rate (default 10)\n"
+        << "  --trigger-source S   Software or Line1 (default Software)\n"
+        << "  --trigger-timeout-ms Trigger without frame after this is missed (default 500)\n"
+        << "  --miss-every N       Simulated camera misses every N-th trigger\n"
+        << "  --trigger-csv PATH   Write one line per trigger to PATH\n"
+        << "  --result-log PATH    Append every result to the binary result log PATH\n"
+        << "  --history N          Keep the last N frames, archive the frames around every NOK\n"
+        << "  --history-dir DIR    Archive directory (default history)\n";
+}
+
+// Trigger burst against the synthetic camera: every trigger is correlated with its frame and verdict
+static int runTriggerBurst(SyntheticSourceConfig sourceConfig, const PipelineConfig& pipelineConfig,
+    const MockEngineConfig& engineConfig, const TriggerBurstConfig& burstConfig, const std::string& csvPath) {
+    sourceConfig.linePulseHz = burstConfig.rateHz;
+    SyntheticCameraSource source(sourceConfig);
+    TriggerBurst burst(source, burstConfig);
+    if (burstConfig.source == "Line1") {
+        // The simulator reports its line pulses, like an I/O card watching the trigger line
+        source.setTriggerObserver([&burst](uint64_t triggerNs) { burst.onTrigger(triggerNs); });
+    }
+
+    InspectionPipeline pipeline(pipelineConfig,
+        [engineConfig] { return std::unique_ptr<IInspectionEngine>(new MockInspectionEngine(engineConfig)); },
+        [&burst](const InspectedFrame& inspected) { burst.onResult(inspected); });
+    if (!pipeline.start()) {
+        return 1;
+    }
+    // Armed before streaming, so no free-running frame slips in
+    if (!source.configureTrigger(burstConfig.source, burstConfig.delayUs) ||
+        !source.startStream(burst.wrap([&pipeline](FrameHandle frame) { pipeline.submit(std::move(frame)); }))) {
+        std::cerr << "Failed to start synthetic source." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Trigger burst: " << burstConfig.count << " x " << burstConfig.source
+        << " at " << burstConfig.rateHz << " Hz on " << source.description() << std::endl;
+    const TriggerBurstReport report = burst.run();
+    source.stopStream();
+    pipeline.stop();
+
+    std::cout << report.text();
+    if (!csvPath.empty() && !report.writeCsv(csvPath)) {
+        return 1;
+    }
+    return 0;
+}
+
+// Several synthetic cameras through CameraManager, one pipeline and engine set per camera
+static int runCameras(const std::string& path, double seconds, const MockEngineConfig& engineConfig,
+    const MetricsExporterConfig& exporterConfig) {
+    std::vector<CameraConfig> configs;
+    if (!loadCameraConfigs(path, configs)) {
+        return 1;
+    }
+
+    MetricsRegistry metrics;
+    CameraManager manager(
+        [](const CameraConfig& config) -> std::unique_ptr<ICameraSource> {
+            if (config.source != "synthetic") {
+                std::cerr << "dtx-bench only runs synthetic cameras, " << config.name << " is " << config.source << std::endl;
+                return nullptr;
+            }
+            SyntheticSourceConfig synthetic;
+            if (config.width > 0) synthetic.width = config.width;
+            if (config.height > 0) synthetic.height = config.height;
+            synthetic.format = config.pixelFormat == "Mono8" ? FramePixelFormat::Mono8 :
+                config.pixelFormat == "BGR8" ? FramePixelFormat::BGR8 : FramePixelFormat::RGB8;
+            synthetic.fps = config.fps;
+            synthetic.bufferCount = config.bufferCount;
+            synthetic.replayPath = config.replayPath;
+            synthetic.numaNode = config.numaNode;
+            return std::unique_ptr<ICameraSource>(new SyntheticCameraSource(synthetic));
+        },
+        [engineConfig](const CameraConfig&) -> InspectionPipeline::EngineFactory {
+            return [engineConfig] { return std::unique_ptr<IInspectionEngine>(new MockInspectionEngine(engineConfig)); };
+        });
+
+    if (!manager.open(configs)) {
+        return 1;
+    }
+    manager.attachMetrics(metrics);
+    MetricsExporter exporter(metrics, exporterConfig);
+    if (!exporter.start() || !manager.start()) {
+        return 1;
+    }
+
+    std::cout << "Running " << manager.cameraCount() << " cameras for " << seconds << " s..." << std::endl;
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    const std::string statistics = manager.statisticsText();
+    manager.stop();
+    exporter.stop();
+    if (!exporterConfig.dumpPath.empty()) {
+        MetricsExporter::writeFile(metrics, exporterConfig.dumpPath);
+    }
+
+    std::cout << statistics << metrics.reportText();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    SyntheticSourceConfig sourceConfig;
+    PipelineConfig pipelineConfig;
+    MockEngineConfig engineConfig;
+    engineConfig.caps.rgb8 = true; // Reads what the VisionMaster Image Source reads: Mono8 and RGB8
+    engineConfig.latencyMs = 5.0;
+    engineConfig.jitterMs = 1.0;
+    double seconds = 5.0;
+    MetricsExporterConfig exporterConfig;
+    exporterConfig.dumpIntervalSec = 1.0;
+    std::string camerasPath;
+    TriggerBurstConfig burstConfig;
+    burstConfig.count = 0;
+    std::string triggerCsv;
+    std::string resultLogPath;
+    FrameHistoryConfig historyConfig;
+    historyConfig.capacity = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--width" && hasValue) sourceConfig.width = std::atoi(argv[++i]);
+        else if (arg == "--height" && hasValue) sourceConfig.height = std::atoi(argv[++i]);
+        else if (arg == "--format" && hasValue) {
+            const std::string format = argv[++i];
+            sourceConfig.format = format == "mono8" ? FramePixelFormat::Mono8 :
+                format == "bgr8" ? FramePixelFormat::BGR8 : FramePixelFormat::RGB8;
+        }
+        else if (arg == "--fps" && hasValue) sourceConfig.fps = std::atof(argv[++i]);
+        else if (arg == "--buffers" && hasValue) sourceConfig.bufferCount = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--replay" && hasValue) sourceConfig.replayPath = argv[++i];
+        else if (arg == "--seconds" && hasValue) seconds = std::atof(argv[++i]);
+        else if (arg == "--workers" && hasValue) pipelineConfig.workerCount = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--queue" && hasValue) pipelineConfig.queueCapacity = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--policy" && hasValue) {
+            const std::string policy = argv[++i];
+            pipelineConfig.policy = policy == "block" ? BackpressurePolicy::Block :
+                policy == "drop-newest" ? BackpressurePolicy::DropNewest : BackpressurePolicy::DropOldest;
+        }
+        else if (arg == "--latency-ms" && hasValue) engineConfig.latencyMs = std::atof(argv[++i]);
+        else if (arg == "--jitter-ms" && hasValue) engineConfig.jitterMs = std::atof(argv[++i]);
+        else if (arg == "--engine-bgr8") engineConfig.caps.bgr8 = true;
+        else if (arg == "--metrics-port" && hasValue) exporterConfig.httpPort = std::atoi(argv[++i]);
+        else if (arg == "--metrics-file" && hasValue) exporterConfig.dumpPath = argv[++i];
+        else if (arg == "--cameras" && hasValue) camerasPath = argv[++i];
+        else if (arg == "--trigger-burst" && hasValue) burstConfig.count = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--trigger-rate" && hasValue) burstConfig.rateHz = std::atof(argv[++i]);
+        else if (arg == "--trigger-source" && hasValue) burstConfig.source = argv[++i];
+        else if (arg == "--trigger-timeout-ms" && hasValue) burstConfig.timeoutMs = std::atof(argv[++i]);
+        else if (arg == "--miss-every" && hasValue) sourceConfig.missTriggerEvery = std::atoi(argv[++i]);
+        else if (arg == "--trigger-csv" && hasValue) triggerCsv = argv[++i];
+        else if (arg == "--result-log" && hasValue) resultLogPath = argv[++i];
+        else if (arg == "--history" && hasValue) historyConfig.capacity = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--history-dir" && hasValue) historyConfig.directory = argv[++i];
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (!camerasPath.empty()) {
+        return runCameras(camerasPath, seconds, engineConfig, exporterConfig);
+    }
+    if (burstConfig.count > 0) {
+        return runTriggerBurst(sourceConfig, pipelineConfig, engineConfig, burstConfig, triggerCsv);
+    }
+
+    // Declared first: the pipeline unregisters its counters when it is destroyed
+    MetricsRegistry metrics;
+
+    std::atomic<uint64_t> okCount{ 0 };
+    std::atomic<uint64_t> nokCount{ 0 };
+
+    // Recorders outlive the pipeline that feeds them
+    ResultLog resultLog;
+    if (!resultLogPath.empty() && !resultLog.open(resultLogPath)) {
+        return 1;
+    }
+    std::unique_ptr<FrameHistory> history;
+    if (historyConfig.capacity > 0) {
+        historyConfig.framesBefore = std::min(historyConfig.framesBefore, historyConfig.capacity / 2);
+        historyConfig.framesAfter = std::min(historyConfig.framesAfter, historyConfig.capacity / 4);
+        history.reset(new FrameHistory(historyConfig));
+        if (!history->start()) {
+            return 1;
+        }
+    }
+    FrameHistory* frameHistory = history.get();
+    const bool logResults = !resultLogPath.empty();
+
+    InspectionPipeline pipeline(pipelineConfig,
+        [engineConfig] { return std::unique_ptr<IInspectionEngine>(new MockInspectionEngine(engineConfig)); },
+        [&, frameHistory, logResults](const InspectedFrame& inspected) {
+            if (inspected.result.ok) {
+                ++okCount;
+            }
+            else {
+                ++nokCount;
+            }
+            if (logResults) {
+                resultLog.append(inspected);
+            }
+            if (frameHistory) {
+                frameHistory->record(inspected);
+            }
+        });
+
+    SyntheticCameraSource source(sourceConfig);
+
+    pipeline.attachMetrics(metrics);
+    const int sourceCounters = metrics.addCounters([&source](std::vector<MetricSample>& samples) {
+        const SourceStatistics stats = source.statistics();
+        samples.push_back(MetricSample{ "dtx_source_delivered_total", "", static_cast<double>(stats.delivered), false });
+        samples.push_back(MetricSample{ "dtx_sink_underruns_total", "", static_cast<double>(stats.sinkUnderruns), false });
+    });
+    MetricsExporter exporter(metrics, exporterConfig);
+    if (!exporter.start()) {
+        return 1;
+    }
+
+    if (!pipeline.start()) {
+        return 1;
+    }
+    if (!source.startStream([&pipeline](FrameHandle frame) { pipeline.submit(std::move(frame)); })) {
+        std::cerr << "Failed to start synthetic source." << std::endl;
+        return 1;
+    }
+    std::cout << "Running " << source.description() << " for " << seconds << " s..." << std::endl;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    source.stopStream();
+    pipeline.stop();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    exporter.stop();
+    if (!exporterConfig.dumpPath.empty()) {
+        MetricsExporter::writeFile(metrics, exporterConfig.dumpPath);
+    }
+
+    std::cout << "Frames delivered: " << source.deliveredCount()
+        << ", source underruns: " << source.underrunCount() << std::endl;
+    std::cout << "Frames inspected: " << pipeline.publishedCount()
+        << " (OK " << okCount << ", NOK " << nokCount << ")"
+        << ", dropped: " << pipeline.droppedCount()
+        << ", failed: " << pipeline.failedCount()
+        << ", converted for inspection: " << pipeline.conversionFallbackCount() << std::endl;
+    std::cout << "Throughput: " << pipeline.publishedCount() / elapsed << " frames/s" << std::endl;
+    std::cout << "Peak buffers in flight: " << source.peakBuffersInFlight()
+        << " of " << sourceConfig.bufferCount << std::endl;
+    if (history) {
+        history->stop();
+        std::cout << "History: " << history->recordedCount() << " frames recorded, "
+            << history->skippedCount() << " skipped, " << history->archivesWrittenCount() << " archives written, "
+            << history->archivesDroppedCount() << " dropped" << std::endl;
+    }
+    if (logResults) {
+        resultLog.close();
+        std::cout << "Result log: " << resultLog.writtenCount() << " records written, "
+            << resultLog.droppedCount() << " dropped" << std::endl;
+    }
+    std::cout << metrics.reportText();
+    metrics.removeCounters(sourceCounters);
+    return 0;
+}
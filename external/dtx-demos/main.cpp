@@ -3,12 +3,110 @@
 #include <string>
 #include <thread>   // for sleep
 #include <chrono>
+#include <atomic>
+#include <map>
+#include <memory>
 
 #include "VisionMasterProcessor.h"
+#include "CameraManager.h"
+#include "SyntheticCameraSource.h"
+
+// Headless multi-camera mode: every camera in the config file streams into its own
+// inspection pipeline until Enter is pressed; statistics are printed every 5 s.
+static int runCameraCell(const std::string& configPath) {
+    std::vector<CameraConfig> configs;
+    if (!loadCameraConfigs(configPath, configs)) {
+        return -1;
+    }
+
+    // A procedure takes one image at a time; cameras sharing one would wait for each other
+    std::map<std::string, std::string> procedureOwners;
+    for (const CameraConfig& config : configs) {
+        const std::vector<std::string> procedures = config.procedures.empty() ?
+            std::vector<std::string>{ "Flow1" } : config.procedures;
+        for (const std::string& procedure : procedures) {
+            auto owner = procedureOwners.emplace(procedure, config.name);
+            if (!owner.second && owner.first->second != config.name) {
+                std::cerr << "Cameras " << owner.first->second << " and " << config.name << " share procedure "
+                    << procedure << ", give every camera its own procedure." << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    ic4::initLibrary();
+
+    CameraManager manager(
+        [](const CameraConfig& config) -> std::unique_ptr<ICameraSource> {
+            if (config.source == "synthetic") {
+                SyntheticSourceConfig synthetic;
+                if (config.width > 0) synthetic.width = config.width;
+                if (config.height > 0) synthetic.height = config.height;
+                synthetic.format = config.pixelFormat == "Mono8" ? FramePixelFormat::Mono8 :
+                    config.pixelFormat == "BGR8" ? FramePixelFormat::BGR8 : FramePixelFormat::RGB8;
+                synthetic.fps = config.fps;
+                synthetic.bufferCount = config.bufferCount;
+                synthetic.replayPath = config.replayPath;
+                synthetic.numaNode = config.numaNode;
+                return std::unique_ptr<ICameraSource>(new SyntheticCameraSource(synthetic));
+            }
+
+            std::unique_ptr<TISCameraIC4> camera(new TISCameraIC4());
+            if (config.width > 0 && config.height > 0) {
+                camera->setResolution(config.width, config.height);
+            }
+            camera->setSinkBufferCount(config.bufferCount);
+            camera->setSinkPixelFormat(config.pixelFormat == "Mono8" ? ic4::PixelFormat::Mono8 :
+                config.pixelFormat == "BGR8" ? ic4::PixelFormat::BGR8 : ic4::PixelFormat::RGB8);
+            if (!camera->connectBySerial(config.serial)) {
+                return nullptr;
+            }
+            return std::unique_ptr<ICameraSource>(camera.release());
+        },
+        [](const CameraConfig& config) -> InspectionPipeline::EngineFactory {
+            // Every worker gets its own engine object on the camera's procedures, in turn; workers
+            // on the same procedure take turns, so give a camera one procedure per worker to scale
+            const std::string solution = config.solutionPath.empty() ? "ok_nok.solw" : config.solutionPath;
+            const std::vector<std::string> procedures = config.procedures.empty() ?
+                std::vector<std::string>{ "Flow1" } : config.procedures;
+            std::shared_ptr<std::atomic<size_t>> nextWorker = std::make_shared<std::atomic<size_t>>(0);
+            return [solution, procedures, nextWorker] {
+                const std::string& procedure = procedures[(*nextWorker)++ % procedures.size()];
+                return std::unique_ptr<IInspectionEngine>(new VisionMasterProcessor(solution, procedure));
+            };
+        });
+
+    if (!manager.open(configs) || !manager.start()) {
+        return -1;
+    }
 
+    std::cout << "Running " << manager.cameraCount() << " camera(s). Press Enter to stop." << std::endl;
+    std::atomic<bool> stopRequested{ false };
+    std::thread input([&stopRequested] {
+        std::string line;
+        std::getline(std::cin, line);
+        stopRequested = true;
+    });
+
+    auto nextReport = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() >= nextReport) {
+            std::cout << manager.statisticsText() << std::endl;
+            nextReport += std::chrono::seconds(5);
+        }
+    }
+    input.join();
 
+    manager.stop();
+    std::cout << manager.statisticsText();
+    return 0;
+}
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return runCameraCell(argv[1]);
+    }
 
     cv::Mat colorImage = cv::imread("a.png", cv::IMREAD_COLOR);
     if (colorImage.empty()) {
@@ -196,7 +294,21 @@ int main() {
 
     ic4::initLibrary();
 
+    // Every result goes to the log, the frames around every NOK to history/
+    ResultLog resultLog;
+    if (!resultLog.open("results.dtxlog")) {
+        std::cerr << "Failed to open the result log." << std::endl;
+        return -1;
+    }
+    FrameHistory history;
+    if (!history.start()) {
+        std::cerr << "Failed to start the frame history." << std::endl;
+        return -1;
+    }
+
     TISCameraIC4 camera;
+    camera.setResultLog(&resultLog);
+    camera.setFrameHistory(&history);
     camera.listCameras();
 
     int index;
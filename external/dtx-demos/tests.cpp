@@ -0,0 +1,422 @@
+// Off-line regression tests of the grab -> inspect path against the synthetic source and
+// the mock engine. Run through ctest, or directly: dtx-tests [test name].
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "InspectionPipeline.h"
+#include "LatencyHistogram.h"
+#include "LatestSlot.h"
+#include "MockInspectionEngine.h"
+#include "ResultLog.h"
+#include "SyntheticCameraSource.h"
+#include "TriggerBurst.h"
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+static FrameHandle makeFrame(uint64_t frameNumber, uint64_t hostTimestampNs = 0) {
+    std::shared_ptr<Frame> frame = std::make_shared<Frame>();
+    frame->frameNumber = frameNumber;
+    frame->hostTimestampNs = hostTimestampNs != 0 ? hostTimestampNs : steadyNowNs();
+    return frame;
+}
+
+static std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("dtx-tests-" + name)).string();
+}
+
+// --- LatestSlot ---
+
+static void testLatestSlot() {
+    LatestSlot<std::shared_ptr<int>> slot;
+    std::shared_ptr<int> value;
+    CHECK(!slot.take(value));
+
+    std::shared_ptr<int> first = std::make_shared<int>(1);
+    slot.publish(first);
+    slot.publish(std::make_shared<int>(2));
+    // The superseded value is released on the producer side
+    CHECK(first.use_count() == 1);
+    CHECK(slot.hasNew());
+
+    slot.publish(std::make_shared<int>(3));
+    CHECK(slot.take(value) && *value == 3);
+    CHECK(!slot.hasNew());
+    CHECK(!slot.take(value));
+
+    slot.publish(std::make_shared<int>(4));
+    CHECK(slot.take(value) && *value == 4);
+}
+
+// --- BoundedQueue ---
+
+static void testBoundedQueuePolicies() {
+    int dropped = 0;
+    int out = 0;
+    uint64_t ticket = 0;
+
+    BoundedQueue<int> oldest(2, BackpressurePolicy::DropOldest);
+    CHECK(oldest.push(1, dropped) == BoundedQueue<int>::PushResult::Queued);
+    CHECK(oldest.push(2, dropped) == BoundedQueue<int>::PushResult::Queued);
+    CHECK(oldest.push(3, dropped) == BoundedQueue<int>::PushResult::DroppedOldest && dropped == 1);
+    // Tickets count pops, the evicted item took none
+    CHECK(oldest.pop(out, &ticket) && out == 2 && ticket == 0);
+    CHECK(oldest.pop(out, &ticket) && out == 3 && ticket == 1);
+
+    BoundedQueue<int> newest(2, BackpressurePolicy::DropNewest);
+    newest.push(1, dropped);
+    newest.push(2, dropped);
+    CHECK(newest.push(3, dropped) == BoundedQueue<int>::PushResult::DroppedNewest && dropped == 3);
+    CHECK(newest.pop(out) && out == 1);
+
+    BoundedQueue<int> block(1, BackpressurePolicy::Block);
+    block.push(1, dropped);
+    std::atomic<bool> pushed{ false };
+    std::thread producer([&] {
+        int rejected = 0;
+        block.push(2, rejected);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!pushed);
+    CHECK(block.pop(out) && out == 1);
+    producer.join();
+    CHECK(pushed);
+
+    // Closed: pushes fail, queued items can still be popped
+    block.close();
+    CHECK(block.push(3, dropped) == BoundedQueue<int>::PushResult::Closed && dropped == 3);
+    CHECK(block.pop(out) && out == 2);
+    CHECK(!block.pop(out));
+}
+
+// --- InspectionPipeline reorder stage ---
+
+// Takes longer on every third frame, so workers finish out of order
+class StaggeredEngine : public IInspectionEngine {
+public:
+    bool runOnFrame(const ImageView&, InspectionResult& result) override {
+        if (result.frameNumber % 3 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        }
+        result.valid = true;
+        result.ok = true;
+        return true;
+    }
+    uint64_t conversionFallbackCount() const override { return 0; }
+};
+
+static void testReorderStage() {
+    // Bursts of drop-oldest evictions used to overwrite reorder slots and hang publishing
+    PipelineConfig config;
+    config.workerCount = 4;
+    config.queueCapacity = 2;
+    config.policy = BackpressurePolicy::DropOldest;
+    config.reorderWindow = 2;
+
+    std::mutex mutex;
+    std::vector<uint64_t> sequences;
+    std::vector<uint64_t> frameNumbers;
+    InspectionPipeline pipeline(config,
+        [] { return std::unique_ptr<IInspectionEngine>(new StaggeredEngine()); },
+        [&](const InspectedFrame& inspected) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sequences.push_back(inspected.result.sequence);
+            frameNumbers.push_back(inspected.result.frameNumber);
+        });
+    CHECK(pipeline.start());
+    for (uint64_t i = 0; i < 500; ++i) {
+        pipeline.submit(makeFrame(i));
+    }
+    pipeline.stop();
+
+    CHECK(pipeline.submittedCount() == 500);
+    CHECK(pipeline.droppedCount() > 0);
+    CHECK(pipeline.publishedCount() + pipeline.droppedCount() == 500);
+    CHECK(sequences.size() == pipeline.publishedCount());
+    for (size_t i = 0; i < sequences.size(); ++i) {
+        CHECK(sequences[i] == i);
+        CHECK(i == 0 || frameNumbers[i] > frameNumbers[i - 1]);
+    }
+}
+
+// --- LatencyHistogram ---
+
+static void testLatencyHistogram() {
+    LatencyHistogram histogram;
+    for (uint64_t us = 1; us <= 1000; ++us) {
+        histogram.record(us * 1000);
+    }
+    histogram.recordInterval(0, 5000);     // Missing start, ignored
+    histogram.recordInterval(5000, 4000);  // Negative, ignored
+
+    const HistogramSnapshot snapshot = histogram.snapshot();
+    CHECK(snapshot.count == 1000);
+    CHECK(snapshot.max == 1000000);
+    CHECK(snapshot.sum == 500500000);
+    const double p50 = static_cast<double>(snapshot.percentile(0.5));
+    const double p99 = static_cast<double>(snapshot.percentile(0.99));
+    CHECK(p50 > 500000 * 0.96 && p50 < 500000 * 1.04);
+    CHECK(p99 > 990000 * 0.96 && p99 < 990000 * 1.04);
+    CHECK(HistogramSnapshot().percentile(0.5) == 0);
+
+    for (size_t index : { size_t(0), size_t(31), size_t(32), size_t(100), LatencyHistogram::kBucketCount - 1 }) {
+        CHECK(LatencyHistogram::bucketIndex(LatencyHistogram::bucketValue(index)) == index);
+    }
+}
+
+// --- ResultLog ---
+
+static size_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+static void appendResults(ResultLog& log, uint64_t first, uint64_t count) {
+    for (uint64_t sequence = first; sequence < first + count; ++sequence) {
+        InspectedFrame inspected;
+        inspected.result.sequence = sequence;
+        inspected.result.valid = true;
+        const float values[2] = { 1.0f, static_cast<float>(sequence) };
+        inspected.result.outputs.add(ResultValues::Float, values, 2);
+        inspected.result.outputs.addEmpty(false);
+        log.append(inspected);
+    }
+}
+
+static void testResultLog() {
+    const std::string path = tempPath("results.dtxlog");
+    std::remove(path.c_str());
+    const size_t headerSize = sizeof(ResultLogHeader);
+    const size_t recordSize = sizeof(ResultLogRecord);
+
+    {
+        ResultLog log;
+        CHECK(log.open(path));
+        appendResults(log, 0, 3);
+        log.close();
+        CHECK(log.writtenCount() == 3);
+    }
+    CHECK(fileSize(path) == headerSize + 3 * recordSize);
+
+    // A crash mid-record leaves a partial record; open() cuts it off before appending
+    {
+        std::ofstream partial(path, std::ios::binary | std::ios::app);
+        partial << "partial";
+    }
+    {
+        ResultLog log;
+        CHECK(log.open(path));
+        appendResults(log, 3, 1);
+        log.close();
+    }
+    CHECK(fileSize(path) == headerSize + 4 * recordSize);
+
+    std::ifstream file(path, std::ios::binary);
+    ResultLogHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    const ResultLogHeader expected = ResultLog::currentHeader();
+    CHECK(std::memcmp(&header, &expected, sizeof(header)) == 0);
+    for (uint64_t sequence = 0; sequence < 4; ++sequence) {
+        ResultLogRecord record;
+        CHECK(file.read(reinterpret_cast<char*>(&record), sizeof(record)));
+        CHECK(record.sequence == sequence);
+        CHECK(record.valid == 1);
+        CHECK(record.paramCount == 2 && record.valueCount == 2);
+        CHECK(record.paramTypes[0] == ResultValues::Float && record.paramSizes[0] == 2);
+        CHECK(record.paramTypes[1] == ResultValues::Empty && record.paramSizes[1] == 0);
+        CHECK(record.values[1] == static_cast<double>(sequence));
+    }
+    file.close();
+
+    // Another layout is never appended to
+    {
+        std::ofstream other(path, std::ios::binary | std::ios::trunc);
+        other << std::string(headerSize, 'x');
+    }
+    ResultLog log;
+    CHECK(!log.open(path));
+    std::remove(path.c_str());
+}
+
+// --- TriggerBurst ---
+
+// Camera that answers every software trigger synchronously from a script: deliver the
+// frame, lose it on the way (its frame number is skipped) or report the trigger as missed
+class ScriptedCamera : public ICameraSource {
+public:
+    enum class Outcome { Frame, LostFrame, Missed };
+
+    std::vector<Outcome> script;
+    FrameCallback callback;
+    size_t triggers = 0;
+    uint64_t frameCounter = 0;
+    uint64_t missed = 0;
+    double exposureUs = 5000.0;
+
+    bool startStream(FrameCallback frameCallback) override {
+        callback = std::move(frameCallback);
+        return true;
+    }
+    bool stopStream() override {
+        callback = nullptr;
+        return true;
+    }
+    bool streaming() const override { return callback != nullptr; }
+    bool setExposure(double value) override {
+        exposureUs = value;
+        return true;
+    }
+    double getExposure() override { return exposureUs; }
+    std::string description() const override { return "Scripted"; }
+    size_t buffersInFlight() const override { return 0; }
+    size_t peakBuffersInFlight() const override { return 0; }
+    SourceStatistics statistics() override {
+        SourceStatistics stats;
+        stats.missedTriggers = missed;
+        return stats;
+    }
+    bool configureTrigger(const std::string&, double) override { return true; }
+    bool disableTriggerMode() override { return true; }
+
+    bool sendSoftwareTrigger() override {
+        const Outcome outcome = triggers < script.size() ? script[triggers] : Outcome::Frame;
+        ++triggers;
+        if (outcome == Outcome::Missed) {
+            ++missed;
+            return true;
+        }
+        const uint64_t frameNumber = frameCounter++;
+        if (outcome == Outcome::Frame && callback) {
+            // Stamped one exposure after the trigger, like a real frame
+            callback(makeFrame(frameNumber, steadyNowNs() + static_cast<uint64_t>(exposureUs * 1000)));
+        }
+        return true;
+    }
+};
+
+static void testTriggerBurstScripted() {
+    using Outcome = ScriptedCamera::Outcome;
+    ScriptedCamera camera;
+    camera.script = { Outcome::Frame, Outcome::Frame, Outcome::Frame, Outcome::LostFrame, Outcome::Frame,
+        Outcome::Frame, Outcome::Missed, Outcome::Frame, Outcome::Frame, Outcome::Frame };
+
+    TriggerBurstConfig config;
+    config.count = camera.script.size();
+    config.rateHz = 200.0;
+    config.timeoutMs = 50.0;
+    TriggerBurst burst(camera, config);
+    camera.startStream(burst.wrap([&burst](FrameHandle frame) {
+        InspectedFrame inspected;
+        inspected.result.frameNumber = frame->frameNumber;
+        inspected.result.valid = true;
+        inspected.frame = std::move(frame);
+        burst.onResult(inspected);
+    }));
+
+    const TriggerBurstReport report = burst.run();
+    CHECK(report.triggers.size() == 10);
+    CHECK(report.missedTriggers == 2);
+    CHECK(report.unmatchedFrames == 0);
+    CHECK(report.uninspected == 0);
+
+    // Matched in firing order; the lost frame and the missed trigger only cost their own trigger
+    const int64_t expectedFrame[10] = { 0, 1, 2, -1, 4, 5, -1, 6, 7, 8 };
+    for (size_t i = 0; i < report.triggers.size() && i < 10; ++i) {
+        const TriggerRecord& record = report.triggers[i];
+        CHECK(record.matched == (expectedFrame[i] >= 0));
+        if (record.matched) {
+            CHECK(record.frameNumber == static_cast<uint64_t>(expectedFrame[i]));
+            CHECK(record.inspected);
+        }
+    }
+}
+
+static void testTriggerBurstSynthetic() {
+    SyntheticSourceConfig sourceConfig;
+    sourceConfig.width = 64;
+    sourceConfig.height = 48;
+    sourceConfig.missTriggerEvery = 5;
+    SyntheticCameraSource source(sourceConfig);
+
+    TriggerBurstConfig config;
+    config.count = 20;
+    config.rateHz = 50.0;
+    TriggerBurst burst(source, config);
+
+    PipelineConfig pipelineConfig;
+    MockEngineConfig engineConfig;
+    engineConfig.caps.rgb8 = true;
+    InspectionPipeline pipeline(pipelineConfig,
+        [engineConfig] { return std::unique_ptr<IInspectionEngine>(new MockInspectionEngine(engineConfig)); },
+        [&burst](const InspectedFrame& inspected) { burst.onResult(inspected); });
+    CHECK(pipeline.start());
+    CHECK(source.configureTrigger(config.source, config.delayUs));
+    CHECK(source.startStream(burst.wrap([&pipeline](FrameHandle frame) { pipeline.submit(std::move(frame)); })));
+
+    const TriggerBurstReport report = burst.run();
+    source.stopStream();
+    pipeline.stop();
+
+    // Every fifth trigger is skipped by the camera, the others get their frame in order
+    CHECK(report.missedTriggers == 4);
+    CHECK(report.unmatchedFrames == 0);
+    uint64_t nextFrame = 0;
+    for (const TriggerRecord& record : report.triggers) {
+        CHECK(record.matched == ((record.id + 1) % 5 != 0));
+        if (record.matched) {
+            CHECK(record.frameNumber == nextFrame);
+            CHECK(record.frameNs >= record.triggerNs + 5000000); // Never before the exposure ends
+            ++nextFrame;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::vector<std::pair<std::string, std::function<void()>>> tests = {
+        { "latest_slot", testLatestSlot },
+        { "bounded_queue_policies", testBoundedQueuePolicies },
+        { "reorder_stage", testReorderStage },
+        { "latency_histogram", testLatencyHistogram },
+        { "result_log", testResultLog },
+        { "trigger_burst_scripted", testTriggerBurstScripted },
+        { "trigger_burst_synthetic", testTriggerBurstSynthetic },
+    };
+
+    const std::string only = argc > 1 ? argv[1] : "";
+    bool found = false;
+    for (const auto& test : tests) {
+        if (!only.empty() && test.first != only) {
+            continue;
+        }
+        found = true;
+        const int before = failures;
+        test.second();
+        std::cout << (failures == before ? "PASS " : "FAIL ") << test.first << std::endl;
+    }
+    if (!found) {
+        std::cerr << "Unknown test " << only << std::endl;
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}